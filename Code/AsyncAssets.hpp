@@ -0,0 +1,267 @@
+#pragma once
+#include <RavenApp/RavenApp.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace OSU {
+namespace Detail {
+	template <typename T> struct TLoadState {
+		std::atomic<bool> IsDone{false};
+		std::atomic<bool> IsCancelled{false};
+		Raven::Handle<T>  Result{}; // Written once before IsDone is set
+	};
+
+	//! Serialises SAssetManager::Load, see LoadAsset. Urgent loads announce
+	//! themselves when they are requested and other loads that did not start
+	//! yet wait for them, so they never queue behind a long decode.
+	class CLoadLock {
+	  public:
+		static CLoadLock& Get() {
+			static CLoadLock s_lock;
+			return s_lock;
+		}
+
+		//! Other loads wait until the returned token is released
+		std::shared_ptr<void> Announce() {
+			{
+				std::scoped_lock lock{m_mutex};
+				++m_urgentCount;
+			}
+			return std::shared_ptr<void>{nullptr, [this](void*) {
+											 {
+												 std::scoped_lock lock{m_mutex};
+												 --m_urgentCount;
+											 }
+											 m_released.notify_all();
+										 }};
+		}
+
+		class Guard {
+		  public:
+			explicit Guard(const bool isUrgent) {
+				auto&            loadLock = Get();
+				std::unique_lock lock{loadLock.m_mutex};
+				loadLock.m_released.wait(lock, [&] {
+					return !loadLock.m_isLocked && (isUrgent || loadLock.m_urgentCount == 0);
+				});
+				loadLock.m_isLocked = true;
+			}
+			~Guard() {
+				auto& loadLock = Get();
+				{
+					std::scoped_lock lock{loadLock.m_mutex};
+					loadLock.m_isLocked = false;
+				}
+				loadLock.m_released.notify_all();
+			}
+
+			Guard(const Guard&)            = delete;
+			Guard& operator=(const Guard&) = delete;
+		};
+
+	  private:
+		std::mutex              m_mutex;
+		std::condition_variable m_released;
+		uint32                  m_urgentCount = 0;
+		bool                    m_isLocked    = false;
+	};
+} // namespace Detail
+
+//! SAssetManager makes no promise about concurrent loads and image loads may
+//! upload to the GPU, so every load that can overlap one on another thread goes
+//! through here. Work around the load, like generating the file, stays parallel.
+//! Urgent loads have to be announced first, see CAsyncAssets and ELoadPriority::High.
+inline auto LoadAsset(Raven::App& app, const std::string& path, const bool isUrgent = false) {
+	Detail::CLoadLock::Guard lock{isUrgent};
+	return app.GetResource<Raven::SAssetManager>()->Load(app, path);
+}
+
+enum class ELoadPriority : uint8 {
+	Normal = 0,
+	Low,  // Speculative, bounded and only run when no normal load is waiting
+	High, // Needed on screen now, runs first and loads that did not start wait for it
+};
+
+//! Asset that is being loaded by CAsyncAssets. Cheap to copy, all copies
+//! observe the same load.
+template <typename T> class TAssetFuture {
+  public:
+	TAssetFuture() = default;
+	explicit TAssetFuture(std::shared_ptr<Detail::TLoadState<T>> state)
+		: m_state(std::move(state)) {}
+
+	bool IsValid() const { return m_state != nullptr; }
+	//! Identifies the load, e.g. for CAsyncAssets::Prioritise
+	const void* GetId() const { return m_state.get(); }
+	bool IsReady() const {
+		return m_state && m_state->IsDone.load(std::memory_order_acquire);
+	}
+	//! Empty until the load finished, stays empty if it failed
+	Raven::Handle<T> Get() const {
+		return IsReady() ? m_state->Result : Raven::Handle<T>{};
+	}
+	//! Skips the load if it did not start yet and drops the result otherwise
+	void Cancel() {
+		if (m_state)
+			m_state->IsCancelled.store(true, std::memory_order_relaxed);
+		m_state.reset();
+	}
+
+  private:
+	std::shared_ptr<Detail::TLoadState<T>> m_state;
+};
+
+//! Runs SAssetManager::Load on worker threads so file I/O and decoding never
+//! stall a frame. Systems keep the returned future and poll it every frame.
+class CAsyncAssets {
+  public:
+	static constexpr uint32 MaxLowPriorityJobs = 32;
+
+	explicit CAsyncAssets(
+		const uint32 workerCount = std::max(std::thread::hardware_concurrency() / 2, 1u)) {
+		for (uint32 i = 0; i < workerCount; ++i) {
+			m_workers.emplace_back([this](std::stop_token stop) { Run(stop); });
+		}
+	}
+
+	~CAsyncAssets() {
+		for (auto& worker : m_workers)
+			worker.request_stop();
+		m_wakeUp.notify_all();
+	}
+
+	CAsyncAssets(const CAsyncAssets&)            = delete;
+	CAsyncAssets& operator=(const CAsyncAssets&) = delete;
+
+	//! Low priority loads are refused with an invalid future when the queue is full
+	template <typename T>
+	TAssetFuture<T> Load(std::string path, const ELoadPriority priority = ELoadPriority::Normal) {
+		return LoadWith<T>(
+			[path = std::move(path)]() -> std::optional<std::string> { return path; },
+			priority);
+	}
+
+	//! Like Load, but the path is produced by `getPath` on the worker, e.g.
+	//! after generating a derived file. A nullopt path fails the load.
+	template <typename T, typename FnT>
+	TAssetFuture<T> LoadWith(FnT getPath, const ELoadPriority priority = ELoadPriority::Normal) {
+		return LoadWithFallback<T>(
+			std::move(getPath),
+			[](const std::string&) -> std::optional<std::string> { return std::nullopt; },
+			priority);
+	}
+
+	//! Like LoadWith, but when the path fails to load `getFallback` is given it
+	//! and may name another one, e.g. the source of a derived file that broke
+	template <typename T, typename FnT, typename FallbackT>
+	TAssetFuture<T> LoadWithFallback(FnT getPath, FallbackT getFallback,
+									 const ELoadPriority priority = ELoadPriority::Normal) {
+		auto       state    = std::make_shared<Detail::TLoadState<T>>();
+		const bool isUrgent = priority == ELoadPriority::High;
+		Job        job{};
+		job.Id          = state.get();
+		job.IsCancelled = std::shared_ptr<const std::atomic<bool>>{state, &state->IsCancelled};
+		// Released with the job, once it ran or was dropped
+		auto urgency = isUrgent ? Detail::CLoadLock::Get().Announce() : nullptr;
+		job.Run      = [state, getPath = std::move(getPath), getFallback = std::move(getFallback),
+					isUrgent, urgency = std::move(urgency)] {
+			// Done with an empty result, futures still shared elsewhere never hang
+			if (state->IsCancelled.load(std::memory_order_relaxed)) {
+				state->IsDone.store(true, std::memory_order_release);
+				return;
+			}
+			std::optional<std::string> path = getPath();
+			while (path) {
+				auto hRes = LoadAsset(Raven::App::Get(), *path, isUrgent);
+				if (hRes.IsSuccess()) {
+					state->Result = hRes.OnSuccess().template Typed<T>();
+					break;
+				}
+				RavenLogWarning("Failed to load {}: {}", *path, hRes.OnFailed());
+				path = getFallback(*path);
+			}
+			// A cancelled result is released by the last future going away
+			state->IsDone.store(true, std::memory_order_release);
+		};
+		const bool isSent = Enqueue(priority, std::move(job));
+		return isSent ? TAssetFuture<T>{std::move(state)} : TAssetFuture<T>{};
+	}
+
+	//! Moves a low priority load that did not start yet to the normal queue,
+	//! for when a speculative load turns out to be needed now
+	template <typename T> void Prioritise(const TAssetFuture<T>& future) {
+		std::scoped_lock lock{m_mutex};
+		const auto it = std::ranges::find(m_lowJobs, future.GetId(), &Job::Id);
+		if (it == std::end(m_lowJobs))
+			return;
+		m_jobs.emplace_back(std::move(*it));
+		m_lowJobs.erase(it);
+	}
+
+	uint32 GetPendingCount() const {
+		std::scoped_lock lock{m_mutex};
+		return static_cast<uint32>(m_jobs.size() + m_lowJobs.size());
+	}
+
+  private:
+	struct Job {
+		std::function<void()>                    Run;
+		const void*                              Id = nullptr; // TAssetFuture::GetId
+		std::shared_ptr<const std::atomic<bool>> IsCancelled;
+	};
+
+	bool Enqueue(const ELoadPriority priority, Job job) {
+		{
+			std::scoped_lock lock{m_mutex};
+			if (priority == ELoadPriority::Low) {
+				// Cancelled loads give their slot back
+				std::erase_if(m_lowJobs, [](const Job& queued) {
+					return queued.IsCancelled->load(std::memory_order_relaxed);
+				});
+				if (m_lowJobs.size() >= MaxLowPriorityJobs)
+					return false;
+				m_lowJobs.emplace_back(std::move(job));
+			} else if (priority == ELoadPriority::High) {
+				m_jobs.emplace_front(std::move(job));
+			} else {
+				m_jobs.emplace_back(std::move(job));
+			}
+		}
+		m_wakeUp.notify_one();
+		return true;
+	}
+
+	void Run(std::stop_token stop) {
+		while (!stop.stop_requested()) {
+			Job job{};
+			{
+				std::unique_lock lock{m_mutex};
+				if (!m_wakeUp.wait(lock, stop, [this] {
+						return !m_jobs.empty() || !m_lowJobs.empty();
+					}))
+					return;
+				auto& queue = m_jobs.empty() ? m_lowJobs : m_jobs;
+				job         = std::move(queue.front());
+				queue.pop_front();
+			}
+			job.Run();
+		}
+	}
+
+	mutable std::mutex                m_mutex;
+	std::condition_variable_any       m_wakeUp;
+	std::deque<Job>                   m_jobs;
+	std::deque<Job>                   m_lowJobs;
+	std::vector<std::jthread>         m_workers; // Last, joined before the queue dies
+};
+
+struct AsyncAssets {
+	std::shared_ptr<CAsyncAssets> Loader = std::make_shared<CAsyncAssets>();
+};
+} // namespace OSU
@@ -0,0 +1,102 @@
+#pragma once
+#include <RavenApp/RavenApp.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace OSU {
+//! Monotonic high resolution wall time in milliseconds
+inline double GetMonotonicTimeMs() {
+	using namespace std::chrono;
+	return duration<double, std::milli>(steady_clock::now().time_since_epoch())
+		.count();
+}
+
+//! Gameplay clock anchored to the audio position.
+//! The audio position only advances once per mixer buffer, so between updates
+//! the time is extrapolated with a monotonic timer. Drift against the audio is
+//! corrected gradually, large jumps (seeks, stalls) snap the clock.
+class CGameClock {
+  public:
+	struct Stats {
+		uint32 Samples      = 0;
+		double MeanDrift    = 0.0; // ms, audio minus extrapolated time
+		double DriftM2      = 0.0; // Welford accumulator for the variance
+		double MaxAbsDrift  = 0.0;
+		double MaxFrameStep = 0.0; // Largest time advance between two updates
+
+		double GetDriftStdDev() const {
+			return Samples > 1 ? std::sqrt(DriftM2 / (Samples - 1)) : 0.0;
+		}
+	};
+
+	static constexpr double CorrectionRate = 0.1;   // Fraction of drift removed per audio update
+	static constexpr double SnapThreshold  = 100.0; // ms
+
+	void Reset(const double audioTime, const double now, const float speed = 1.f) {
+		m_anchorTime  = audioTime;
+		m_anchorWall  = now;
+		m_lastAudio   = audioTime;
+		m_time        = audioTime;
+		m_speed       = speed;
+		m_stats       = Stats{};
+	}
+
+	//! Advances the clock to `now` given the last reported audio position
+	double Update(const double audioTime, const double now, const float speed = 1.f) {
+		if (speed != m_speed) {
+			// Re-anchor so a speed change does not rescale the elapsed time
+			m_anchorTime = Extrapolate(now);
+			m_anchorWall = now;
+			m_speed      = speed;
+		}
+
+		if (audioTime != m_lastAudio) {
+			m_lastAudio          = audioTime;
+			const double drift   = audioTime - Extrapolate(now);
+			RecordDrift(drift);
+			if (std::abs(drift) > SnapThreshold) {
+				m_anchorTime = audioTime;
+				m_anchorWall = now;
+				// A late starting device reports a position behind the
+				// extrapolated time, hold the clock until the audio catches up
+				m_time = std::max(m_time, audioTime);
+				return m_time;
+			}
+			m_anchorTime += drift * CorrectionRate;
+		}
+
+		// Never run backwards while correcting
+		const double next    = std::max(m_time, Extrapolate(now));
+		m_stats.MaxFrameStep = std::max(m_stats.MaxFrameStep, next - m_time);
+		m_time               = next;
+		return m_time;
+	}
+
+	//! Gameplay time at an arbitrary wall clock timestamp, e.g. of an input event
+	double GetTimeAt(const double now) const { return Extrapolate(now); }
+	double GetTime() const { return m_time; }
+	const Stats& GetStats() const { return m_stats; }
+
+  private:
+	double Extrapolate(const double now) const {
+		return m_anchorTime + (now - m_anchorWall) * m_speed;
+	}
+
+	void RecordDrift(const double drift) {
+		++m_stats.Samples;
+		const double delta = drift - m_stats.MeanDrift;
+		m_stats.MeanDrift += delta / m_stats.Samples;
+		m_stats.DriftM2 += delta * (drift - m_stats.MeanDrift);
+		m_stats.MaxAbsDrift = std::max(m_stats.MaxAbsDrift, std::abs(drift));
+	}
+
+	double m_anchorTime = 0.0;
+	double m_anchorWall = 0.0;
+	double m_lastAudio  = 0.0;
+	double m_time       = 0.0;
+	float  m_speed      = 1.f;
+	Stats  m_stats{};
+};
+} // namespace OSU
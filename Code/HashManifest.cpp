@@ -0,0 +1,83 @@
+#include "HashManifest.hpp"
+#include "ImageCodec.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace OSU {
+CHashManifest::CHashManifest(std::filesystem::path file) : m_file(std::move(file)) {
+	// hash size writeTime path, one source per line
+	std::ifstream manifest{m_file};
+	std::string   line;
+	while (std::getline(manifest, line)) {
+		std::istringstream stream{line};
+		Source             source{};
+		std::string        path;
+		stream >> std::hex >> source.Hash >> std::dec >> source.Size >> source.WriteTime >>
+			std::ws;
+		std::getline(stream, path);
+		if (stream.fail() || path.empty())
+			continue;
+		m_sources.emplace(std::move(path), source);
+	}
+}
+
+std::optional<uint64> CHashManifest::GetHash(const std::filesystem::path& source) {
+	std::error_code err;
+	const auto      key  = source.string();
+	const auto      size = std::filesystem::file_size(source, err);
+	if (err) {
+		// Gone, whatever was derived from it is stale
+		std::scoped_lock lock{m_mutex};
+		if (m_sources.erase(key) != 0)
+			m_isDirty = true;
+		return std::nullopt;
+	}
+	const auto writeTime = static_cast<int64>(
+		std::filesystem::last_write_time(source, err).time_since_epoch().count());
+	{
+		std::scoped_lock lock{m_mutex};
+		const auto       it = m_sources.find(key);
+		if (it != std::end(m_sources) && it->second.Size == size &&
+			it->second.WriteTime == writeTime)
+			return it->second.Hash;
+	}
+
+	const auto bytes = ImageCodec::ReadFile(source);
+	if (!bytes)
+		return std::nullopt;
+	const auto hash = ImageCodec::HashBytes(*bytes);
+	std::scoped_lock lock{m_mutex};
+	m_sources[key] = Source{.Size = size, .WriteTime = writeTime, .Hash = hash};
+	m_isDirty      = true;
+	return hash;
+}
+
+bool CHashManifest::HasHash(const uint64 hash) const {
+	std::scoped_lock lock{m_mutex};
+	return std::ranges::any_of(m_sources,
+							   [hash](const auto& source) { return source.second.Hash == hash; });
+}
+
+bool CHashManifest::Save() {
+	std::scoped_lock lock{m_mutex};
+	if (!m_isDirty)
+		return false;
+	const auto    tmpPath = std::filesystem::path{m_file}.concat(".tmp");
+	std::ofstream manifest{tmpPath, std::ios::trunc};
+	for (const auto& [path, source] : m_sources) {
+		manifest << fmt::format("{:016x} {} {} {}\n", source.Hash, source.Size,
+								source.WriteTime, path);
+	}
+	manifest.close();
+	std::error_code err;
+	std::filesystem::rename(tmpPath, m_file, err);
+	if (err) {
+		RavenLogWarning("Failed to save {}: {}", m_file.string(), err.message());
+		return false;
+	}
+	m_isDirty = false;
+	return true;
+}
+} // namespace OSU
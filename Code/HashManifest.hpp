@@ -0,0 +1,41 @@
+#pragma once
+#include <RavenApp/RavenApp.hpp>
+
+#include <filesystem>
+#include <mutex>
+
+namespace OSU {
+//! Content hashes of source files, remembered with their size and write time
+//! so an unchanged file is never read again just to hash it. Kept as a text
+//! file next to the cache it belongs to. Thread-safe.
+class CHashManifest {
+  public:
+	explicit CHashManifest(std::filesystem::path file);
+	~CHashManifest() { Save(); }
+
+	CHashManifest(const CHashManifest&)            = delete;
+	CHashManifest& operator=(const CHashManifest&) = delete;
+
+	//! Hash of the contents of `source`, empty if it cannot be read. A source
+	//! that was deleted is forgotten.
+	std::optional<uint64> GetHash(const std::filesystem::path& source);
+
+	//! Whether any remembered source currently has this hash
+	bool HasHash(uint64 hash) const;
+
+	//! Persists the manifest if it changed since the last save, true if it did
+	bool Save();
+
+  private:
+	struct Source {
+		uintmax_t Size      = 0;
+		int64     WriteTime = 0;
+		uint64    Hash      = 0;
+	};
+
+	std::filesystem::path                   m_file;
+	mutable std::mutex                      m_mutex;
+	std::unordered_map<std::string, Source> m_sources; // By source path
+	bool                                    m_isDirty = false;
+};
+} // namespace OSU
@@ -0,0 +1,166 @@
+#include "Hitsounds.hpp"
+#include "AsyncAssets.hpp"
+#include "GameClock.hpp"
+#include "StartupTasks.hpp"
+
+#include <RavenAudio/RavenAudio.hpp>
+
+#include <filesystem>
+
+namespace OSU {
+using namespace Raven;
+
+namespace Detail {
+	constexpr std::array SampleSetNames = {"normal", "soft", "drum"};
+	constexpr std::array HitSoundNames  = {"hitnormal", "hitwhistle",
+										   "hitfinish", "hitclap"};
+} // namespace Detail
+
+ESampleSet ParseSampleSet(const std::string_view name) {
+	return name == "Soft"   ? ESampleSet::Soft
+		 : name == "Drum"   ? ESampleSet::Drum
+							: ESampleSet::Normal;
+}
+
+//! Tags the pooled players, see HitsoundVoices
+struct HitsoundVoice {};
+
+//! Fixed pool of players hitsounds are played through. Voices and their
+//! players are created once per map and retriggered round-robin, a hit never
+//! creates an entity or a component.
+struct HitsoundVoices {
+	static constexpr uint32 VoiceCount = 16;
+
+	std::array<TEntity, VoiceCount> Voices{};
+	uint32                          Next = 0;
+
+	// From the judged hit to the player being retriggered, the mixer and the
+	// output buffer come on top and are not measured
+	uint32 Played       = 0;
+	double TotalLatency = 0.0;
+	double MaxLatency   = 0.0;
+};
+
+// Skin samples are required, beatmap ones are optional overrides
+HitsoundBank::TSamples LoadSamples(App& app, const std::string_view dir,
+								   const bool isOptional) {
+	HitsoundBank::TSamples samples{};
+	for (size_t set = 0; set < samples.size(); ++set) {
+		for (size_t sound = 0; sound < HitsoundBank::SoundsPerSet; ++sound) {
+			const auto path =
+				fmt::format("{}{}-{}.wav", dir, Detail::SampleSetNames[set],
+							Detail::HitSoundNames[sound]);
+			if (isOptional && !std::filesystem::exists(path))
+				continue;
+			auto hRes = LoadAsset(app, path);
+			if (hRes.IsSuccess()) {
+				samples[set][sound] = hRes.OnSuccess().Typed<Audio::Sound>();
+			} else if (!isOptional) {
+				RavenLogWarning("Failed to load hitsound {}", path);
+				RavenLogWarning("Reason: {}", hRes.OnFailed());
+			}
+		}
+	}
+	return samples;
+}
+
+void SpawnHitsoundVoices(
+	CWorld& world, App& app, HitsoundBank& bank,
+	HitsoundVoices& voices, const Assets<CBeatmap>& beatmaps,
+	const Query<With<CBeatmapController>>& controllers) {
+	for (auto hController : controllers) {
+		const auto* pBeatmap =
+			beatmaps.Get(controllers.get<CBeatmapController>(hController).Beatmap);
+		if (!pBeatmap)
+			continue;
+		bank.Beatmap =
+			LoadSamples(app, fmt::format("{}/", pBeatmap->GetDirectory()), true);
+		bank.DefaultSet = ParseSampleSet(pBeatmap->GetGeneral().SampleSet);
+		break;
+	}
+
+	for (auto& hVoice : voices.Voices) {
+		hVoice = world.CreateEntity("HitsoundVoice");
+		world.AddComponent<Tags::NoSerialise>(hVoice);
+		world.AddComponent<Tags::NoCopy>(hVoice);
+		world.AddComponent<HitsoundVoice>(hVoice);
+		world.AddComponent<Audio::Player>(
+			hVoice, Audio::Player{.Sound         = bank.Skin[0][0],
+								  .PlaybackSpeed = 1.f,
+								  .Volume        = 1.f,
+								  .IsLooping     = false,
+								  .IsPlaying     = false});
+	}
+	voices.Next         = 0;
+	voices.Played       = 0;
+	voices.TotalLatency = 0.0;
+	voices.MaxLatency   = 0.0;
+}
+
+void PlayHitsounds(const HitsoundQueue& hitsounds, const HitsoundBank& bank,
+				   HitsoundVoices&                                   voices,
+				   const Query<With<HitsoundVoice, Audio::Player>>& players) {
+	while (const auto trigger = hitsounds.Queue->TryPop()) {
+		const double latency = GetMonotonicTimeMs() - trigger->Time;
+		++voices.Played;
+		voices.TotalLatency += latency;
+		voices.MaxLatency = std::max(voices.MaxLatency, latency);
+
+		const auto set = static_cast<size_t>(trigger->SampleSet);
+		for (uint32 sound = 0; sound < HitsoundBank::SoundsPerSet; ++sound) {
+			// Bit 0 is the normal sample which is always played
+			if (sound != 0 && !IsBitSet(trigger->HitSound, sound))
+				continue;
+			const auto& hSample = bank.Beatmap[set][sound] ? bank.Beatmap[set][sound]
+														   : bank.Skin[set][sound];
+			if (!hSample)
+				continue;
+			const auto hVoice = voices.Voices[voices.Next];
+			voices.Next       = (voices.Next + 1) % HitsoundVoices::VoiceCount;
+			players.storage<Audio::Player>().patch(hVoice, [&hSample](Audio::Player& player) {
+				player.Sound       = hSample;
+				player.PlayingTime = 0;
+				player.IsPlaying   = true;
+			});
+		}
+	}
+}
+
+void ReleaseHitsoundVoices(CWorld& world, const HitsoundQueue& hitsounds,
+						   HitsoundBank& bank, HitsoundVoices& voices) {
+	for (auto& hVoice : voices.Voices) {
+		if (hVoice)
+			world.RemoveEntity(hVoice);
+		hVoice = TEntity{};
+	}
+	bank.Beatmap = {};
+
+	if (voices.Played > 0) {
+		RavenLogInfo("Hitsound trigger to dispatch latency over {} hits: mean {:.3f}ms, "
+					 "max {:.3f}ms",
+					 voices.Played, voices.TotalLatency / voices.Played,
+					 voices.MaxLatency);
+	}
+	if (const uint32 dropped = hitsounds.Dropped->exchange(0); dropped > 0) {
+		RavenLogWarning("Dropped {} hitsound triggers on a full queue", dropped);
+	}
+}
+
+void BuildHitsoundPlugin(App& app) {
+	app.AddComponent<HitsoundVoice>()
+		.CreateResource<HitsoundQueue>()
+		.CreateResource<HitsoundVoices>()
+		.CreateResource<HitsoundBank>()
+		.AddSystem(OSU::StateStage, GameStartSystem(&SpawnHitsoundVoices))
+		.AddSystem(OSU::StateStage, GameExitSystem(&ReleaseHitsoundVoices))
+		.AddSystem(DefaultStages::UPDATE, GameSystem(&PlayHitsounds));
+
+	auto pSamples = std::make_shared<HitsoundBank::TSamples>();
+	app.GetResource<StartupTasks>()->Tasks->Add(
+		"Hitsounds",
+		[&app, pSamples] {
+			*pSamples = LoadSamples(app, DefaultSkinDir, false);
+		},
+		[&app, pSamples] { app.GetResource<HitsoundBank>()->Skin = *pSamples; });
+}
+} // namespace OSU
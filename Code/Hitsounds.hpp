@@ -0,0 +1,60 @@
+#pragma once
+#include "RavenOSU.hpp"
+#include "SPSCQueue.hpp"
+
+#include <atomic>
+
+namespace Raven::Audio {
+class Sound;
+}
+
+namespace OSU {
+enum class ESampleSet : uint8 {
+	Normal = 0,
+	Soft,
+	Drum,
+
+	Count,
+};
+
+//! Bits of HitObject::HitSound, a plain hit always plays the normal sample
+enum EHitSound : uint8 {
+	HitNormal  = 0,
+	HitWhistle = 1 << 1,
+	HitFinish  = 1 << 2,
+	HitClap    = 1 << 3,
+};
+
+struct HitsoundTrigger {
+	ESampleSet SampleSet = ESampleSet::Normal;
+	uint8      HitSound  = HitNormal;
+	double     Time      = 0.0; // Monotonic wall time (ms) of the trigger
+};
+
+struct HitsoundQueue {
+	using TQueue = TSPSCQueue<HitsoundTrigger, 64>;
+	std::shared_ptr<TQueue> Queue = std::make_shared<TQueue>();
+	// Triggers lost to a full queue, reported when the voices are released
+	std::shared_ptr<std::atomic<uint32>> Dropped = std::make_shared<std::atomic<uint32>>(0);
+
+	void Trigger(const ESampleSet set, const int hitSound, const double time) const {
+		if (Queue->TryPush(HitsoundTrigger{set, static_cast<uint8>(hitSound), time}))
+			return;
+		if (Dropped->fetch_add(1, std::memory_order_relaxed) == 0)
+			RavenLogWarning("Hitsound queue is full, dropping hitsounds!");
+	}
+};
+
+//! Samples decoded up front, beatmap samples override the skin ones
+struct HitsoundBank {
+	static constexpr uint32 SoundsPerSet = 4; // normal, whistle, finish, clap
+	using TSet     = std::array<Raven::Handle<Raven::Audio::Sound>, SoundsPerSet>;
+	using TSamples = std::array<TSet, static_cast<size_t>(ESampleSet::Count)>;
+
+	TSamples   Skin{};
+	TSamples   Beatmap{};
+	ESampleSet DefaultSet = ESampleSet::Normal;
+};
+
+ESampleSet ParseSampleSet(std::string_view name);
+} // namespace OSU
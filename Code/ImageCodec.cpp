@@ -0,0 +1,109 @@
+#include "ImageCodec.hpp"
+
+#include <fstream>
+#include <thread>
+
+// Private copies so they never clash with the engine's image loader
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+namespace OSU::ImageCodec {
+uint64 HashBytes(const std::span<const char> bytes) {
+	uint64 hash = 14695981039346656037ull;
+	for (const char c : bytes) {
+		hash ^= static_cast<uint8>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+std::optional<std::vector<char>> ReadFile(const std::filesystem::path& path) {
+	std::ifstream file{path, std::ios::binary};
+	if (!file)
+		return std::nullopt;
+	return std::vector<char>{std::istreambuf_iterator<char>{file}, {}};
+}
+
+std::optional<CPixels> Decode(const std::span<const char> bytes, const std::string_view name) {
+	int   width = 0, height = 0, channels = 0;
+	auto* pPixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(bytes.data()),
+										  static_cast<int>(bytes.size()), &width, &height,
+										  &channels, 4);
+	if (!pPixels) {
+		RavenLogWarning("Failed to decode {}: {}", name, stbi_failure_reason());
+		return std::nullopt;
+	}
+	CPixels pixels{};
+	pixels.Width  = static_cast<uint32>(width);
+	pixels.Height = static_cast<uint32>(height);
+	pixels.Rgba.assign(pPixels, pPixels + static_cast<size_t>(width) * height * 4);
+	stbi_image_free(pPixels);
+	return pixels;
+}
+
+CPixels Downscale(const CPixels& src, const uint32 width, const uint32 height) {
+	constexpr uint32 Channels = 4;
+	CPixels          dst{};
+	dst.Width  = width;
+	dst.Height = height;
+	dst.Rgba.resize(static_cast<size_t>(width) * height * Channels);
+	for (uint32 y = 0; y < height; ++y) {
+		const uint32 y0 = y * src.Height / height;
+		const uint32 y1 = std::max((y + 1) * src.Height / height, y0 + 1);
+		for (uint32 x = 0; x < width; ++x) {
+			const uint32 x0 = x * src.Width / width;
+			const uint32 x1 = std::max((x + 1) * src.Width / width, x0 + 1);
+
+			std::array<uint32, Channels> sum{};
+			for (uint32 sy = y0; sy < y1; ++sy) {
+				const uint8* pRow =
+					src.Rgba.data() + (static_cast<size_t>(sy) * src.Width + x0) * Channels;
+				for (uint32 sx = x0; sx < x1; ++sx, pRow += Channels) {
+					for (uint32 c = 0; c < Channels; ++c)
+						sum[c] += pRow[c];
+				}
+			}
+			const uint32 count = (y1 - y0) * (x1 - x0);
+			uint8* pDst = dst.Rgba.data() + (static_cast<size_t>(y) * width + x) * Channels;
+			for (uint32 c = 0; c < Channels; ++c)
+				pDst[c] = static_cast<uint8>(sum[c] / count);
+		}
+	}
+	return dst;
+}
+
+bool Write(const std::filesystem::path& path, const CPixels& pixels, const EImageFormat format) {
+	// Uncompressed TGA, the cached textures are loaded without any decoding work.
+	// Set once, writers on other threads only ever read it.
+	[[maybe_unused]] static const bool s_isTgaRleDisabled = [] {
+		stbi_write_tga_with_rle = 0;
+		return true;
+	}();
+
+	const auto tmpPath = std::filesystem::path{path}.concat(
+		fmt::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id())));
+	const auto tmpName = tmpPath.string();
+	const auto width   = static_cast<int>(pixels.Width);
+	const auto height  = static_cast<int>(pixels.Height);
+	const bool isWritten =
+		format == EImageFormat::Png
+			? stbi_write_png(tmpName.c_str(), width, height, 4, pixels.Rgba.data(), width * 4)
+			: stbi_write_tga(tmpName.c_str(), width, height, 4, pixels.Rgba.data());
+	if (!isWritten) {
+		RavenLogWarning("Failed to write {}", tmpName);
+		return false;
+	}
+
+	std::error_code err;
+	std::filesystem::rename(tmpPath, path, err);
+	if (err) {
+		std::filesystem::remove(tmpPath, err);
+		return std::filesystem::exists(path);
+	}
+	return true;
+}
+} // namespace OSU::ImageCodec
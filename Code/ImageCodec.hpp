@@ -0,0 +1,35 @@
+#pragma once
+#include <RavenApp/RavenApp.hpp>
+
+#include <filesystem>
+
+namespace OSU {
+//! Decoded 8 bit RGBA image
+struct CPixels {
+	uint32             Width  = 0;
+	uint32             Height = 0;
+	std::vector<uint8> Rgba;
+};
+
+enum class EImageFormat : uint8 {
+	Png = 0,
+	Tga, // Uncompressed, loading it is little more than a copy
+};
+
+namespace ImageCodec {
+	// FNV-1a
+	uint64 HashBytes(std::span<const char> bytes);
+
+	std::optional<std::vector<char>> ReadFile(const std::filesystem::path& path);
+
+	//! Decodes any format stb_image knows, logs failures
+	std::optional<CPixels> Decode(std::span<const char> bytes, std::string_view name);
+
+	//! Box filter, every destination pixel averages the source pixels it covers
+	CPixels Downscale(const CPixels& src, uint32 width, uint32 height);
+
+	//! Written under a per-thread name and renamed, threads racing on the same
+	//! path never expose a partial file
+	bool Write(const std::filesystem::path& path, const CPixels& pixels, EImageFormat format);
+} // namespace ImageCodec
+} // namespace OSU
@@ -0,0 +1,90 @@
+#pragma once
+#include "SPSCQueue.hpp"
+
+#include <RavenApp/RavenApp.hpp>
+#include <IInput.h>
+#include <limits>
+#include <memory>
+
+namespace OSU {
+//! Key press edge with the monotonic wall time (ms) of the frame it arrived in.
+//! The engine's SKeyPress carries no timestamp and is delivered once per frame,
+//! so the press happened somewhere between Since and Time. It is judged against
+//! the cursor path of that span, see CursorPath::Intersects.
+struct KeyPress {
+	EKey   Key   = EKey::D;
+	double Time  = 0.0; // Same stamp as the cursor samples of its frame
+	double Since = 0.0; // Previous frame
+};
+
+struct KeyPressQueue {
+	using TQueue = TSPSCQueue<KeyPress, 256>;
+	std::shared_ptr<TQueue> Queue = std::make_shared<TQueue>();
+};
+
+constexpr std::array GameplayKeys = {EKey::D, EKey::F};
+
+inline bool SegmentIntersectsCircle(const float2 a, const float2 b,
+									const float2 center, const float radius) {
+	const float2 ab    = b - a;
+	const float  lenSq = glm::dot(ab, ab);
+	const float  t =
+		lenSq > 0.f ? std::clamp(glm::dot(center - a, ab) / lenSq, 0.f, 1.f)
+					: 0.f;
+	const float2 closest = a + ab * t;
+	return glm::dot(center - closest, center - closest) < radius * radius;
+}
+
+//! Every raw cursor sample (OSU pixel space) of the last few hundred
+//! milliseconds, so hit tests cover the path travelled between frames rather
+//! than only the latest position. SMouseMove carries no timestamp, samples
+//! hold the time of the frame they arrived in and are never interpolated.
+struct CursorPath {
+	static constexpr uint32 Capacity = 512;
+
+	struct Sample {
+		float2 Pos{};
+		double Time = 0.0; // Monotonic wall time in ms
+	};
+
+	void Push(const float2 pos, const double time) {
+		Samples[Head] = Sample{pos, time};
+		Head          = (Head + 1) % Capacity;
+		Count         = std::min(Count + 1, Capacity);
+		++TotalCount;
+	}
+
+	const Sample& At(const uint32 i) const { // 0 is the oldest sample
+		return Samples[(Head + Capacity - Count + i) % Capacity];
+	}
+
+	//! Tests the path travelled after `since` and up to `until` against a
+	//! circle, later samples are ignored
+	bool Intersects(const float2 center, const float radius, const double since,
+					const double until = std::numeric_limits<double>::max()) const {
+		if (Count == 0)
+			return false;
+		uint32 i = Count;
+		while (i > 1 && At(i - 1).Time > until)
+			--i;
+		for (; i > 1; --i) {
+			const auto& prev = At(i - 2);
+			const auto& next = At(i - 1);
+			if (next.Time <= since) // No movement since then
+				return glm::distance(next.Pos, center) < radius;
+			if (SegmentIntersectsCircle(prev.Pos, next.Pos, center, radius))
+				return true;
+			if (prev.Time <= since)
+				return false;
+		}
+		return glm::distance(At(0).Pos, center) < radius;
+	}
+
+	std::array<Sample, Capacity> Samples{};
+	uint32                       Head              = 0;
+	uint32                       Count             = 0;
+	uint64                       TotalCount        = 0; // Ever pushed, identifies samples
+	double                       PreviousFrameTime = 0.0;
+	double                       LastFrameTime     = 0.0;
+};
+} // namespace OSU
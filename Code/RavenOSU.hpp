@@ -15,6 +15,7 @@ enum class EGameState{
 	Paused,
 };
 constexpr inline auto StateStage = Raven::DefaultStages::FIRST;
+constexpr inline std::string_view DefaultSkinDir = "project://Assets/Skins/- YUGEN -/";
 
 struct HitCurve {
 	enum Type {
@@ -40,6 +41,7 @@ struct HitObject {
 	int                                    X, Y;
 	int                                    Time;
 	int                                    Type;
+	int                                    HitSound = 0; // EHitSound bits
 	std::variant<std::monostate, HitCurve> ObjectParams{std::monostate{}};
 };
 struct Difficulty {
@@ -51,12 +53,24 @@ struct Difficulty {
 	float SliderTickRate    = 1.f;
 };
 
+//! Rate changing mods. The song plays at Rate and the gameplay clock follows
+//! the player's PlaybackSpeed, so all beatmap timing scales with it.
+//! TODO: The pitch changes with the rate. Keeping it needs a pitch-preserving
+//! time-stretch in RavenAudio's mixer, which offers no DSP hook to the game.
+struct GameMods {
+	static constexpr float DoubleTime = 1.5f;
+	static constexpr float HalfTime   = 0.75f;
+
+	float Rate = 1.f;
+};
+
 struct General {
 	std::string AudioFilename;
 	int         AudioLeadIn = 0;
 	std::string AudioHash;
 	int         PreviewTime = 0;
 	int         Countdown   = 0;
+	std::string SampleSet   = "Normal";
 };
 
 struct DifficultyProperties {
@@ -67,16 +81,154 @@ struct DifficultyProperties {
 	float DurationTotal = 0.f;
 };
 
+//! Objects appear at HitObject::Time and are due once the approach circle
+//! closed, Preempt milliseconds later
+inline float GetHitTime(const HitObject& hitObj, const DifficultyProperties& props) {
+	return static_cast<float>(hitObj.Time) + props.Preempt;
+}
+
+//! Half-widths (ms) around the hit time for each judgement
+struct HitWindows {
+	float Great;
+	float Ok;
+	float Meh;
+
+	static HitWindows FromOD(const float od) {
+		return HitWindows{
+			.Great = 80.f - 6.f * od,
+			.Ok    = 140.f - 8.f * od,
+			.Meh   = 200.f - 10.f * od,
+		};
+	}
+
+	//! Score for a press `offset` ms away from the hit time, 0 if outside
+	int Score(const float offset) const {
+		const float absOffset = std::abs(offset);
+		return absOffset <= Great ? 300
+			 : absOffset <= Ok    ? 100
+			 : absOffset <= Meh   ? 50
+								  : 0;
+	}
+};
+
 struct VisibilityProperties {
 	float TimeSinceSpawn;
 	float ApproachAmount; // 0 to 1 where 1 is fully apprached
 	float SliderT;
 };
 
-struct Hovered{};
+//! Entities that never move relative to their parent. Their world transform
+//! is resolved once by ResolveStaticTransforms instead of the engine's
+//! per-frame transform propagation.
+struct StaticTransform {
+	float3 Local{};
+};
+//! Parent translation the static children were last resolved against
+struct StaticTransformRoot {
+	float3 Applied{};
+	bool   IsDirty = true;
+};
+
+inline std::optional<VisibilityProperties>
+ComputeVisibility(const HitObject& hitObj, const DifficultyProperties& props,
+				  const double currentTime) {
+	const float dt = static_cast<float>(currentTime - hitObj.Time);
+	if (dt <= 0 || dt >= props.Preempt + props.DurationTotal)
+		return std::nullopt;
+
+	const auto durationFac = dt - props.Preempt;
+	const auto iteration   = static_cast<int>(
+		  std::floor(durationFac / props.DurationSingle));
+	const auto slideTime = durationFac - iteration * props.DurationSingle;
+	const auto t         = iteration % 2 == 0
+							   ? slideTime / props.DurationSingle
+							   : 1.f - (slideTime / props.DurationSingle);
+	return VisibilityProperties{
+		.TimeSinceSpawn = dt,
+		.ApproachAmount = glm::lerp(
+			1.f, 0.5f, std::clamp(dt, 0.f, props.Preempt) / props.Preempt),
+		.SliderT = t * static_cast<float>(dt >= props.Preempt),
+	};
+}
+
+//! Attached to a hit object once it received a score (including misses)
+struct Judged {
+	int Score = 0;
+};
+
+struct JudgementEffect {
+	static constexpr float Lifetime = 500.f; // ms, extended by slider duration
+
+	float2 Position{}; // OSU pixel space
+	int    Score          = 0;
+	float  TimeSinceSpawn = 0.f;
+	float  TotalTime      = 0.f;
+
+	bool IsActive() const { return TimeSinceSpawn < TotalTime; }
+};
+
+//! Fixed-capacity ring of judgement sprites. Effects are recycled in place,
+//! when the ring is full the oldest one is overwritten.
+struct JudgementEffects {
+	static constexpr uint32 Capacity = 64;
+
+	void Push(const JudgementEffect& effect) {
+		Effects[Head] = effect;
+		Head          = (Head + 1) % Capacity;
+	}
+
+	void Advance(const float ms) {
+		for (auto& effect : Effects) {
+			if (effect.IsActive())
+				effect.TimeSinceSpawn += ms;
+		}
+	}
+
+	void Clear() { *this = JudgementEffects{}; }
+
+	std::array<JudgementEffect, Capacity> Effects{};
+	uint32                                Head = 0;
+};
+
 struct ActiveMousePos {
-	uint2          Pos;
-	Raven::TEntity CursorEntity;
+	uint2 Pos;
+};
+
+//! Fixed-size ring of the most recent cursor samples the trail is built from.
+//! Samples closer than MinSpacing are dropped so the trail looks the same
+//! regardless of the mouse polling rate.
+struct CursorTrail {
+	static constexpr uint32 Capacity   = 64;
+	static constexpr float  MinSpacing = 4.f;   // OSU pixels
+	static constexpr float  Lifetime   = 150.f; // ms
+
+	struct Sample {
+		float2 Pos{};
+		double Time = 0.0;
+	};
+
+	void Push(const float2 pos, const double time) {
+		if (Count > 0 && glm::distance(Latest().Pos, pos) < MinSpacing)
+			return;
+		Samples[Head] = Sample{pos, time};
+		Head          = (Head + 1) % Capacity;
+		Count         = std::min(Count + 1, Capacity);
+	}
+
+	const Sample& Latest() const {
+		return Samples[(Head + Capacity - 1) % Capacity];
+	}
+
+	//! Iterates from the oldest to the newest sample
+	template <typename FnT> void ForEach(FnT fn) const {
+		for (uint32 i = 0; i < Count; ++i) {
+			fn(Samples[(Head + Capacity - Count + i) % Capacity]);
+		}
+	}
+
+	std::array<Sample, Capacity> Samples{};
+	uint32                       Head  = 0;
+	uint32                       Count = 0;
 };
 
 struct ResolutionConversion {
@@ -87,11 +239,70 @@ struct ResolutionConversion {
 	float  AspectRatio;
 };
 
+//! Glyphs of the skin's score font, digits are their own value
+enum EScoreGlyph : uint8 {
+	ScoreGlyphDot = 10,
+	ScoreGlyphPercent,
+	ScoreGlyphX,
+
+	ScoreGlyphCount,
+	ScoreGlyphNone = ScoreGlyphCount,
+};
+
 struct Skin {
 	using TImageMap =
 		std::unordered_map<Raven::HashedString, Raven::Handle<Raven::CImage>>;
 
+	static constexpr int32 MaxLevel = 2;
+
 	TImageMap Images;
+	std::array<Raven::Handle<Raven::CImage>, ScoreGlyphCount> ScoreGlyphs{};
+	int32 Level = 0; // Resolution the images were loaded for, see GetLevel
+
+	//! Skins are authored for a 768px tall playfield. -1 picks the @2x images,
+	//! n > 0 the images downscaled by 2^n, whichever is closest to the display.
+	static int32 GetLevel(const float renderHeight) {
+		const auto level = static_cast<int32>(std::lround(std::log2(768.f / renderHeight)));
+		return std::clamp(level, -1, MaxLevel);
+	}
+
+	bool HasScoreGlyphs() const {
+		return std::ranges::all_of(ScoreGlyphs, [](const auto& hImg) { return !!hImg; });
+	}
+};
+
+//! Number drawn as quads of the skin's score glyphs, no text shaping involved.
+//! Only rebuilt by Set when the displayed value changes.
+struct GlyphNumber {
+	static constexpr uint32 MaxGlyphs = 16;
+	static constexpr float  Aspect    = 0.7f; // Glyph width per height
+
+	std::array<uint8, MaxGlyphs> Glyphs{};
+	uint32 Count  = 0;
+	float2 Anchor = {}; // Top edge in osu px of the 640x480 frame
+	float  Height = 0.f; // osu px
+	bool   IsRightAligned = false;
+
+	//! `value` with the last `decimals` digits after a dot, e.g. 9853 -> 98.53
+	void Set(const int32 value, const uint32 decimals = 0,
+			 const uint8 suffix = ScoreGlyphNone) {
+		std::array<uint8, MaxGlyphs> reversed{};
+		uint32 n = 0;
+		if (suffix != ScoreGlyphNone)
+			reversed[n++] = suffix;
+		auto   remaining = static_cast<uint32>(std::max(value, 0));
+		uint32 digit     = 0;
+		do {
+			if (decimals != 0 && digit == decimals)
+				reversed[n++] = ScoreGlyphDot;
+			reversed[n++] = static_cast<uint8>(remaining % 10);
+			remaining /= 10;
+			++digit;
+		} while ((remaining != 0 || digit <= decimals) && n + 2 <= MaxGlyphs);
+
+		Count = n;
+		std::reverse_copy(std::begin(reversed), std::begin(reversed) + n, std::begin(Glyphs));
+	}
 };
 
 struct GameWorld {
@@ -109,6 +320,9 @@ class CBeatmap {
 	const Difficulty& GetDifficulty() const { return m_difficulty; }
 	const General&    GetGeneral() const { return m_general; }
 	const std::string_view GetBackground() const { return m_backgroundPath; }
+	std::string_view       GetDirectory() const { return m_path; }
+	//! The .osu file, identifies the beatmap across loads
+	std::string_view       GetFilePath() const { return m_filePath; }
 
   private:
 	friend class CBeatmapLoader;
@@ -117,13 +331,19 @@ class CBeatmap {
 	std::vector<HitObject> m_hitObjects;
 	std::string            m_backgroundPath;
 	std::string            m_path;
+	std::string            m_filePath;
 };
 
+//! Per hit object derived values, indexed like CBeatmap::GetHitObjects
+using TDifficultyProperties = std::vector<DifficultyProperties>;
+
 struct CBeatmapController {
 	Difficulty              Difficulty{};
 	Raven::Handle<CBeatmap> Beatmap;
-	int64                   CurrentTime = 0;
+	std::shared_ptr<const TDifficultyProperties> Properties;
+	double                  CurrentTime = 0.0; // ms, interpolated by CGameClock
 	int64                   MaxTime     = 0;
+	uint32                  NextObject  = 0; // Next hit object to be spawned
 };
 
 struct GameScores {
@@ -135,13 +355,53 @@ struct GameScores {
 	int32 Hit50 = 0;
 	int32 HitMiss = 0;
 	int32 ScoreRaw = 0;
+
+	bool operator==(const GameScores&) const = default;
+
+	void Add(const int score) {
+		switch (score) {
+		case 0: {
+			Combo = 0;
+			HitMiss++;
+			break;
+		}
+		case 50: {
+			Combo++;
+			Hit50++;
+			break;
+		}
+		case 100: {
+			Combo++;
+			Hit100++;
+			break;
+		}
+		case 300: {
+			Combo++;
+			Hit300++;
+			break;
+		}
+		default:
+			RavenLogWarning("Undefined score value: {}!", score);
+			break;
+		}
+		ScoreRaw += score;
+		Score += score * std::max(1, Combo);
+		MaxCombo = std::max(Combo, MaxCombo);
+	}
 };
+//! Attached next to GameScores whenever it changes, consumed by the HUD
+struct ScoresChanged {};
 
 template <typename T> Raven::SystemDesc GameStartSystem(T&& sys) {
 	return Raven::SystemDesc{std::forward<T>(sys)}.WithCondition(
 		Raven::State<EGameState>::OnEnter(EGameState::Playing));
 }
 
+template <typename T> Raven::SystemDesc GameSystem(T&& sys) {
+	return Raven::SystemDesc{std::forward<T>(sys)}.WithCondition(
+		Raven::State<EGameState>::OnUpdate(EGameState::Playing));
+}
+
 template <typename T> Raven::SystemDesc GameExitSystem(T&& sys) {
 	return Raven::SystemDesc{std::forward<T>(sys)}.WithCondition(
 		Raven::State<EGameState>::OnExit(EGameState::Playing));
@@ -1,4 +1,7 @@
 #include "RavenOSU.hpp"
+#include "Simulation.hpp"
+#include "GameClock.hpp"
+#include "StartupTasks.hpp"
 
 #include <RavenApp/RavenApp.hpp>
 #include <RavenCommon/Mesh.hpp>
@@ -32,6 +35,12 @@ class CRenderingCache {
 		return hMat;
 	}
 
+	//! Forgets the material of a texture that is about to be released, its
+	//! index may be reused by another texture
+	void ReleaseSpriteMaterial(const Handle<CImage>& hTexture) {
+		m_materialCache.erase(hTexture.Index());
+	}
+
 	std::vector<std::pair<uint32, HandleUntyped>> PreviousMaterials;
   private:
 	// Weak handles based on texture+colour lookup
@@ -96,17 +105,45 @@ struct ExtractedHitObject {
 };
 using TExtractedObjects = std::vector<ExtractedHitObject>;
 
+struct ExtractedJudgement {
+	float2 Position;
+	int    Score;
+	float  T; // 0 to 1 over the lifetime of the effect
+};
+using TExtractedJudgements = std::vector<ExtractedJudgement>;
+
+struct ExtractedTrailPoint {
+	float2 Position;
+	float  Opacity;
+};
+using TExtractedTrail = std::vector<ExtractedTrailPoint>;
+
+using TExtractedNumbers = std::vector<GlyphNumber>;
+
+Handle<CImage> GetScoreSpriteTexture(const int score, const Skin& skin) {
+	return score == 300 ? skin.Images.find("hit300")->second
+		 : score == 100 ? skin.Images.find("hit100")->second
+		 : score == 50  ? skin.Images.find("hit50")->second
+						: skin.Images.find("hit0")->second;
+}
+
 void ExtractActiveObjects(TExtractedObjects& dst, 
+	TExtractedJudgements& dstJudgements,
+	const JudgementEffects& effects,
+	TExtractedTrail& dstTrail,
+	const CursorTrail& trail,
+	TExtractedNumbers& dstNumbers,
+	const SimulationState& sim,
+	SimSnapshot& snapshot,
 	CWorld& world,
 	const Query<With<CBeatmapController, SParentComponent>>& controllers,
-	const Query<With<VisibilityProperties, HitObject, WorldSpaceTransform, DifficultyProperties>>& visibleObjects
+	const Query<With<VisibilityProperties, HitObject, WorldSpaceTransform, DifficultyProperties>>& visibleObjects,
+	const Query<With<GlyphNumber>>& numbers
 ) {
-	visibleObjects.each([&](const VisibilityProperties& vis,
-							const HitObject&            hitObj,
-							const WorldSpaceTransform&  xForm,
-							const DifficultyProperties& props) {
+	auto extract = [&](const VisibilityProperties& vis, const HitObject& hitObj,
+					   const float2 position, const DifficultyProperties& props) {
 		auto& obj = dst.emplace_back(ExtractedHitObject{
-			.Position            = xForm.m_translation.xy(),
+			.Position            = position,
 			.Radius              = props.Radius,
 			.ApproachCircleScale = vis.ApproachAmount,
 			.SliderT             = vis.SliderT,
@@ -119,6 +156,51 @@ void ExtractActiveObjects(TExtractedObjects& dst,
 				std::get<HitCurve>(hitObj.ObjectParams).CurvePoints;
 			obj.SliderPoints.insert(std::begin(obj.SliderPoints), obj.Position);
 		}
+	};
+
+	if (sim.IsRunning()) {
+		sim.Thread->ReadSnapshot(snapshot);
+		const auto hitObjects = sim.Thread->GetHitObjects();
+		for (const auto& visible : snapshot.Visible) {
+			extract(visible.Visibility, hitObjects[visible.Index], visible.Position,
+					sim.Thread->GetProperties(visible.Index));
+		}
+	} else {
+		visibleObjects.each([&](const VisibilityProperties& vis,
+								const HitObject&            hitObj,
+								const WorldSpaceTransform&  xForm,
+								const DifficultyProperties& props) {
+			extract(vis, hitObj, xForm.m_translation.xy(), props);
+		});
+	}
+
+	for (const auto& effect : effects.Effects) {
+		if (!effect.IsActive())
+			continue;
+		dstJudgements.emplace_back(ExtractedJudgement{
+			.Position = effect.Position,
+			.Score    = effect.Score,
+			.T        = effect.TimeSinceSpawn / effect.TotalTime,
+		});
+	}
+
+	numbers.each([&](const GlyphNumber& number) {
+		if (number.Count != 0)
+			dstNumbers.emplace_back(number);
+	});
+
+	// Aged against the current time so the trail fades out once the cursor stops
+	const double now = GetMonotonicTimeMs();
+	if (trail.Count == 0 || now - trail.Latest().Time >= CursorTrail::Lifetime)
+		return;
+	trail.ForEach([&](const CursorTrail::Sample& sample) {
+		const float age = static_cast<float>(now - sample.Time);
+		if (age >= CursorTrail::Lifetime)
+			return;
+		dstTrail.emplace_back(ExtractedTrailPoint{
+			.Position = sample.Pos,
+			.Opacity  = 1.f - age / CursorTrail::Lifetime,
+		});
 	});
 }
 } // namespace OSU
@@ -150,6 +232,9 @@ template<>
 struct Raven::TComponentRenderSystem<OSU::HitObject> {
 	static void Draw(CWorld& world, IFrameContext& ctx, const OSU::Skin& skin,
 					 OSU::TExtractedObjects&         extracted,
+					 OSU::TExtractedJudgements&      judgements,
+					 OSU::TExtractedTrail&           trail,
+					 OSU::TExtractedNumbers&         numbers,
 					 Assets<Sprite::SpriteMaterial>& materials,
 					 const Query<With<OSU::ResolutionConversion>>& activeMouse, // resolution scale
 					 Assets<CMesh>& meshes, OSU::CRenderingCache& cache) {
@@ -161,7 +246,8 @@ struct Raven::TComponentRenderSystem<OSU::HitObject> {
 			return px * scale;
 		};
 
-		const size_t spriteCount = extracted.size();
+		const size_t spriteCount =
+			extracted.size() + judgements.size() + trail.size() + numbers.size();
 		if(spriteCount <= 0)
 			return;
 
@@ -306,16 +392,97 @@ struct Raven::TComponentRenderSystem<OSU::HitObject> {
 			}
 		}
 
+		// Judgements rise and grow over their lifetime, fading out in the second half
+		for(const auto& judgement: judgements) {
+			const float2 size = fromOSUPixels(float2{20.f} / float2{ar, 1.f}) *
+								(1.f + 0.5f * judgement.T);
+			const float2 pos =
+				fromOSUPixels(judgement.Position - float2{0.f, 20.f * judgement.T});
+			const float opacity = std::clamp(2.f - 2.f * judgement.T, 0.f, 1.f);
+			queueSprite(pos, size,
+						OSU::GetScoreSpriteTexture(judgement.Score, skin), opacity);
+		}
+
+		// The whole trail shares one texture so it is submitted as a single primitive
+		if(!trail.empty()) {
+			const auto hTrail = skin.Images.contains("cursortrail")
+									? skin.Images.find("cursortrail")
+									: skin.Images.find("cursor");
+			RavenAssert(hTrail != std::end(skin.Images), "Invalid skin!");
+			const float2 size = fromOSUPixels(float2{8.f} / float2{ar, 1.f});
+			for(const auto& point: trail) {
+				const float2 pos = fromOSUPixels(point.Position);
+				OSU::Geometry::AddQuad(*pMesh, pos + float2(-1.f, -1.f) * size,
+									   pos + float2(1.f, -1.f) * size,
+									   pos + float2(-1.f, 1.f) * size,
+									   pos + float2(1.f, 1.f) * size,
+									   float4{1.f, 1.f, 1.f, point.Opacity});
+				++spriteIdx;
+			}
+			addMaterialPrimitive(hTrail->second, spriteIdx, false);
+		}
+
+		// Fixed quads per glyph, laid out from the anchor without any shaping
+		for(const auto& number: numbers) {
+			const float2 size = fromOSUPixels(float2{number.Height * OSU::GlyphNumber::Aspect,
+													 number.Height} * 0.5f / float2{ar, 1.f});
+			const float2 anchor = fromOSUPixels(number.Anchor);
+			const float  width  = size.x * 2.f * static_cast<float>(number.Count);
+			float2 pos = float2{number.IsRightAligned ? anchor.x - width : anchor.x,
+								anchor.y} + size;
+			for(uint32 i = 0; i < number.Count; ++i) {
+				queueSprite(pos, size, skin.ScoreGlyphs[number.Glyphs[i]], 1.f);
+				pos.x += size.x * 2.f;
+			}
+		}
+
 		pMesh->ComputeBounds();
 		extracted.clear();
+		judgements.clear();
+		trail.clear();
+		numbers.clear();
 	}
 };
 
 namespace OSU {
+static void WarmSkinMaterials(CRenderingCache& cache, Assets<Sprite::SpriteMaterial>& materials,
+							  const Skin& skin) {
+	for (const auto& [name, hImage] : skin.Images)
+		cache.GetSpriteMaterialForTexture(materials, hImage, false);
+	for (const auto& hImage : skin.ScoreGlyphs) {
+		if (hImage)
+			cache.GetSpriteMaterialForTexture(materials, hImage, false);
+	}
+}
+
+// Called when skin images were replaced, the first frame drawing the new
+// ones creates no material
+void SwapSkinMaterials(Raven::App& app, const std::span<const Handle<CImage>> released,
+					   const Skin& skin) {
+	auto& cache = *app.GetResource<CRenderingCache>();
+	for (const auto& hImage : released)
+		cache.ReleaseSpriteMaterial(hImage);
+	WarmSkinMaterials(cache, *app.GetResource<Assets<Sprite::SpriteMaterial>>(), skin);
+}
+
 void BuildRenderingPlugin(Raven::App& app) {
 	app.CreateResource<OSU::CRenderingCache>()
 		.CreateResource<OSU::TExtractedObjects>()
+		.CreateResource<OSU::TExtractedJudgements>()
+		.CreateResource<OSU::TExtractedTrail>()
+		.CreateResource<OSU::TExtractedNumbers>()
+		.CreateResource<OSU::SimSnapshot>()
 		.AddSystem(Raven::Renderer::Stages::EXTRACT, &OSU::ExtractActiveObjects)
 		.AddPlugin<Raven::TRenderSystemFor<OSU::HitObject>>();
+
+	// Sprite materials of the skin exist before the first map is drawn
+	app.GetResource<StartupTasks>()->Tasks->Add(
+		"Sprite materials", {},
+		[&app] {
+			WarmSkinMaterials(*app.GetResource<CRenderingCache>(),
+							  *app.GetResource<Assets<Sprite::SpriteMaterial>>(),
+							  *app.GetResource<Skin>());
+		},
+		{"Skin"});
 }
 } // namespace OSU
@@ -0,0 +1,44 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <optional>
+
+namespace OSU {
+//! Bounded lock-free queue for exactly one producer and one consumer thread
+template <typename T, size_t Capacity> class TSPSCQueue {
+	static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two");
+
+  public:
+	//! Returns false when the queue is full, the item is dropped
+	bool TryPush(const T& item) {
+		const size_t head = m_head.load(std::memory_order_relaxed);
+		if (head - m_tail.load(std::memory_order_acquire) == Capacity)
+			return false;
+		m_items[head & Mask] = item;
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	std::optional<T> TryPop() {
+		const size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail == m_head.load(std::memory_order_acquire))
+			return std::nullopt;
+		T item = m_items[tail & Mask];
+		m_tail.store(tail + 1, std::memory_order_release);
+		return item;
+	}
+
+	bool IsEmpty() const {
+		return m_tail.load(std::memory_order_acquire) ==
+			   m_head.load(std::memory_order_acquire);
+	}
+
+  private:
+	static constexpr size_t Mask = Capacity - 1;
+
+	alignas(64) std::atomic<size_t> m_head{0};
+	alignas(64) std::atomic<size_t> m_tail{0};
+	std::array<T, Capacity>         m_items{};
+};
+} // namespace OSU
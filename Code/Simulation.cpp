@@ -0,0 +1,216 @@
+#include "Simulation.hpp"
+
+namespace OSU {
+using namespace Raven;
+
+CSimulationThread::CSimulationThread(
+	std::vector<HitObject>                       hitObjects,
+	std::shared_ptr<const TDifficultyProperties> properties,
+	const Difficulty& difficulty, const float2 rootOffset,
+	const CGameClock& clock, std::shared_ptr<KeyPressQueue::TQueue> presses,
+	HitsoundQueue hitsounds, const ESampleSet sampleSet, const uint32 tickRate)
+	: m_hitObjects(std::move(hitObjects))
+	, m_properties(std::move(properties))
+	, m_windows(HitWindows::FromOD(difficulty.OverallDifficulty))
+	, m_rootOffset(rootOffset)
+	, m_period(std::chrono::nanoseconds{1'000'000'000 / std::max(tickRate, 1u)})
+	, m_presses(std::move(presses))
+	, m_hitsounds(std::move(hitsounds))
+	, m_sampleSet(sampleSet)
+	, m_sharedClock(clock)
+	, m_judged(m_hitObjects.size(), 0) {
+	m_thread = std::jthread{[this](std::stop_token stop) { Run(stop); }};
+}
+
+CSimulationThread::~CSimulationThread() {
+	m_thread.request_stop();
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+void CSimulationThread::PublishClock(const CGameClock& clock) {
+	std::scoped_lock lock{m_clockMutex};
+	m_sharedClock = clock;
+}
+
+void CSimulationThread::PushCursorSample(const CursorPath::Sample& sample) {
+	m_cursorSamples.TryPush(sample);
+}
+
+void CSimulationThread::ReadSnapshot(SimSnapshot& dst) const {
+	std::scoped_lock lock{m_snapshotMutex};
+	dst.Time = m_front.Time;
+	dst.Scores = m_front.Scores;
+	dst.Visible.assign(std::begin(m_front.Visible), std::end(m_front.Visible));
+}
+
+GameScores CSimulationThread::ReadScores() const {
+	std::scoped_lock lock{m_snapshotMutex};
+	return m_front.Scores;
+}
+
+void CSimulationThread::Run(std::stop_token stop) {
+	using Clock = std::chrono::steady_clock;
+	auto next   = Clock::now();
+	while (!stop.stop_requested()) {
+		Tick(GetMonotonicTimeMs());
+
+		// Skip ticks rather than trying to catch up after a stall
+		next += m_period;
+		const auto now = Clock::now();
+		if (now > next + m_period * 10)
+			next = now;
+		std::this_thread::sleep_until(next);
+	}
+}
+
+void CSimulationThread::Tick(const double now) {
+	{
+		std::scoped_lock lock{m_clockMutex};
+		m_clock = m_sharedClock;
+	}
+	m_time = m_clock.GetTimeAt(now);
+
+	while (const auto sample = m_cursorSamples.TryPop()) {
+		m_cursor.Push(sample->Pos, sample->Time);
+	}
+	while (const auto press = m_presses->TryPop()) {
+		JudgePress(*press);
+	}
+
+	const auto size = static_cast<uint32>(m_hitObjects.size());
+	for (uint32 i = m_firstLive; i < size && m_hitObjects[i].Time < m_time; ++i) {
+		if (!m_judged[i] &&
+			m_time > GetHitTime(m_hitObjects[i], GetProperties(i)) + m_windows.Meh) {
+			Judge(i, 0);
+		}
+	}
+	while (m_firstLive < size && m_judged[m_firstLive]) {
+		const auto& props = GetProperties(m_firstLive);
+		if (m_time < m_hitObjects[m_firstLive].Time + props.Preempt + props.DurationTotal)
+			break;
+		++m_firstLive;
+	}
+
+	m_back.Time   = m_time;
+	m_back.Scores = m_scores;
+	m_back.Visible.clear();
+	for (uint32 i = m_firstLive; i < size && m_hitObjects[i].Time < m_time; ++i) {
+		const auto& obj = m_hitObjects[i];
+		if (const auto vis = ComputeVisibility(obj, GetProperties(i), m_time)) {
+			m_back.Visible.emplace_back(SimVisibleObject{
+				.Index      = i,
+				.Position   = GetPosition(obj),
+				.Visibility = *vis,
+			});
+		}
+	}
+
+	std::scoped_lock lock{m_snapshotMutex};
+	std::swap(m_back, m_front);
+}
+
+// Same rules as JudgeKeyPresses: the earliest unjudged object the cursor passed
+// over during the press' frame whose hit window contains the press time
+void CSimulationThread::JudgePress(const KeyPress& press) {
+	if (m_cursor.Count == 0)
+		return;
+	const double pressTime = m_clock.GetTimeAt(press.Time);
+
+	const auto size = static_cast<uint32>(m_hitObjects.size());
+	for (uint32 i = m_firstLive; i < size; ++i) {
+		const auto& props   = GetProperties(i);
+		const float hitTime = GetHitTime(m_hitObjects[i], props);
+		if (hitTime - m_windows.Meh > pressTime)
+			break;
+		if (m_judged[i] || std::abs(pressTime - hitTime) > m_windows.Meh ||
+			!m_cursor.Intersects(GetPosition(m_hitObjects[i]), props.Radius, press.Since,
+								 press.Time))
+			continue;
+		m_hitsounds.Trigger(m_sampleSet, m_hitObjects[i].HitSound, press.Time);
+		Judge(i, m_windows.Score(static_cast<float>(pressTime) - hitTime));
+		return;
+	}
+}
+
+void CSimulationThread::Judge(const uint32 idx, const int score) {
+	m_judged[idx] = 1;
+	m_scores.Add(score);
+	m_judgements.TryPush(SimJudgement{
+		.Score         = score,
+		.Position      = GetPosition(m_hitObjects[idx]),
+		.ExtraDuration = score > 0 ? GetProperties(idx).DurationTotal : 0.f,
+	});
+}
+
+void StartSimulationThread(
+	SimulationState& sim, const SimulationSettings& settings,
+	const KeyPressQueue& presses, const CGameClock& clock,
+	const HitsoundQueue& hitsounds, const HitsoundBank& bank,
+	const Assets<CBeatmap>& beatmaps,
+	const Query<With<CBeatmapController, STransformComponent>>& controllers) {
+	if (!settings.Threaded || sim.IsRunning())
+		return;
+	for (auto hController : controllers) {
+		const auto& controller = controllers.get<CBeatmapController>(hController);
+		const auto* pBeatmap   = beatmaps.Get(controller.Beatmap);
+		if (!pBeatmap || !controller.Properties)
+			continue;
+		const auto hitObjects = pBeatmap->GetHitObjects();
+		sim.Thread = std::make_unique<CSimulationThread>(
+			std::vector<HitObject>{std::begin(hitObjects), std::end(hitObjects)},
+			controller.Properties, controller.Difficulty,
+			controllers.get<STransformComponent>(hController).m_translation.xy(),
+			clock, presses.Queue, hitsounds, bank.DefaultSet, settings.TickRate);
+		sim.ForwardedSamples = 0;
+		break;
+	}
+}
+
+void FeedSimulation(SimulationState& sim, const CGameClock& clock,
+					const CursorPath& path) {
+	if (!sim.IsRunning())
+		return;
+	sim.Thread->PublishClock(clock);
+	// Samples of one frame share their time, new ones are found by count
+	const uint64 firstStored = path.TotalCount - path.Count;
+	for (uint64 i = std::max(sim.ForwardedSamples, firstStored); i < path.TotalCount; ++i)
+		sim.Thread->PushCursorSample(path.At(static_cast<uint32>(i - firstStored)));
+	sim.ForwardedSamples = path.TotalCount;
+}
+
+void ApplySimulationResults(CWorld& world, SimulationState& sim, JudgementEffects& effects,
+							const Query<With<GameScores>>& scores) {
+	if (!sim.IsRunning())
+		return;
+	while (const auto judgement = sim.Thread->PopJudgement()) {
+		effects.Push(JudgementEffect{
+			.Position  = judgement->Position,
+			.Score     = judgement->Score,
+			.TotalTime = JudgementEffect::Lifetime + judgement->ExtraDuration,
+		});
+	}
+	// Left untouched on frames without a new judgement
+	const GameScores latest = sim.Thread->ReadScores();
+	for (auto hScores : scores) {
+		auto& current = scores.get<GameScores>(hScores);
+		if (current != latest) {
+			current = latest;
+			world.AddOrReplace<ScoresChanged>(hScores);
+		}
+	}
+}
+
+void StopSimulationThread(SimulationState& sim) {
+	sim.Thread.reset();
+}
+
+void BuildSimulationPlugin(App& app) {
+	app.CreateResource<SimulationSettings>()
+		.CreateResource<SimulationState>()
+		.AddSystem(DefaultStages::PRE_UPDATE, GameSystem(&StartSimulationThread))
+		.AddSystem(DefaultStages::UPDATE, GameSystem(&FeedSimulation))
+		.AddSystem(DefaultStages::UPDATE, GameSystem(&ApplySimulationResults))
+		.AddSystem(OSU::StateStage, GameExitSystem(&StopSimulationThread));
+}
+} // namespace OSU
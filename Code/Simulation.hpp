@@ -0,0 +1,111 @@
+#pragma once
+#include "RavenOSU.hpp"
+#include "GameClock.hpp"
+#include "Input.hpp"
+#include "Hitsounds.hpp"
+
+#include <mutex>
+#include <thread>
+
+namespace OSU {
+struct SimulationSettings {
+	bool   Threaded = false; // Run judgement on a dedicated fixed rate thread
+	uint32 TickRate = 1000;  // Hz
+};
+
+struct SimVisibleObject {
+	uint32               Index; // Into CSimulationThread::GetHitObjects
+	float2               Position;
+	VisibilityProperties Visibility;
+};
+
+struct SimSnapshot {
+	double                        Time = 0.0;
+	std::vector<SimVisibleObject> Visible;
+	GameScores                    Scores{};
+};
+
+struct SimJudgement {
+	int    Score         = 0;
+	float2 Position      {};
+	float  ExtraDuration = 0.f;
+};
+
+//! Runs visibility and judgement of a single map at a fixed rate, independent
+//! of the render frame. Input arrives through lock-free queues, results are
+//! published as a double-buffered snapshot plus a queue of judgements.
+class CSimulationThread {
+  public:
+	CSimulationThread(std::vector<HitObject>                       hitObjects,
+					  std::shared_ptr<const TDifficultyProperties> properties,
+					  const Difficulty& difficulty, float2 rootOffset,
+					  const CGameClock&                      clock,
+					  std::shared_ptr<KeyPressQueue::TQueue> presses,
+					  HitsoundQueue hitsounds, ESampleSet sampleSet,
+					  uint32        tickRate);
+	~CSimulationThread();
+
+	CSimulationThread(const CSimulationThread&)            = delete;
+	CSimulationThread& operator=(const CSimulationThread&) = delete;
+
+	// Main thread side
+	void PublishClock(const CGameClock& clock);
+	void PushCursorSample(const CursorPath::Sample& sample);
+	std::optional<SimJudgement> PopJudgement() { return m_judgements.TryPop(); }
+	//! Copies the latest published snapshot
+	void ReadSnapshot(SimSnapshot& dst) const;
+	GameScores ReadScores() const;
+
+	// Immutable, safe to read from any thread
+	std::span<HitObject const> GetHitObjects() const { return m_hitObjects; }
+	const DifficultyProperties& GetProperties(const uint32 idx) const {
+		return (*m_properties)[idx];
+	}
+
+  private:
+	void Run(std::stop_token stop);
+	void Tick(double now);
+	void JudgePress(const KeyPress& press);
+	void Judge(uint32 idx, int score);
+	float2 GetPosition(const HitObject& obj) const {
+		return m_rootOffset + float2{obj.X, obj.Y};
+	}
+
+	const std::vector<HitObject>                       m_hitObjects;
+	const std::shared_ptr<const TDifficultyProperties> m_properties;
+	const HitWindows                                   m_windows;
+	const float2                                       m_rootOffset;
+	const std::chrono::nanoseconds                     m_period;
+
+	// Inputs
+	std::shared_ptr<KeyPressQueue::TQueue>       m_presses;
+	const HitsoundQueue                          m_hitsounds;
+	const ESampleSet                             m_sampleSet;
+	TSPSCQueue<CursorPath::Sample, 1024>         m_cursorSamples;
+	mutable std::mutex                           m_clockMutex;
+	CGameClock                                   m_sharedClock;
+
+	// Simulation thread state
+	CGameClock           m_clock;
+	CursorPath           m_cursor;
+	std::vector<uint8>   m_judged;
+	uint32               m_firstLive = 0;
+	double               m_time      = 0.0;
+	GameScores           m_scores{};
+
+	// Outputs
+	TSPSCQueue<SimJudgement, 256> m_judgements;
+	SimSnapshot                   m_back;
+	mutable std::mutex            m_snapshotMutex;
+	SimSnapshot                   m_front;
+
+	std::jthread m_thread;
+};
+
+struct SimulationState {
+	std::unique_ptr<CSimulationThread> Thread;
+	uint64 ForwardedSamples = 0; // CursorPath::TotalCount already sent to the thread
+
+	bool IsRunning() const { return Thread != nullptr; }
+};
+} // namespace OSU
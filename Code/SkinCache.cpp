@@ -0,0 +1,65 @@
+#include "SkinCache.hpp"
+#include "ImageCodec.hpp"
+
+#include <charconv>
+
+namespace OSU {
+CSkinCache::CSkinCache(std::filesystem::path directory)
+	: m_directory(std::move(directory)), m_manifest(m_directory / "manifest.txt") {
+	std::error_code err;
+	std::filesystem::create_directories(m_directory, err);
+	if (err) {
+		RavenLogWarning("Failed to create skin cache {}: {}", m_directory.string(),
+						err.message());
+	}
+}
+
+std::optional<std::string> CSkinCache::GetOrCreate(const std::filesystem::path& source,
+												   const uint32 level) {
+	const auto hash = m_manifest.GetHash(source);
+	if (!hash)
+		return std::nullopt;
+	const auto path = m_directory / fmt::format("{:016x}.{}.tga", *hash, level);
+	if (std::filesystem::exists(path))
+		return path.string();
+
+	const auto bytes = ImageCodec::ReadFile(source);
+	if (!bytes)
+		return std::nullopt;
+	auto image = ImageCodec::Decode(*bytes, source.string());
+	if (!image)
+		return std::nullopt;
+	if (level > 0) {
+		*image = ImageCodec::Downscale(*image, std::max(image->Width >> level, 1u),
+									   std::max(image->Height >> level, 1u));
+	}
+	if (!ImageCodec::Write(path, *image, EImageFormat::Tga))
+		return std::nullopt;
+	return path.string();
+}
+
+void CSkinCache::Remove(const std::filesystem::path& entry) {
+	std::error_code err;
+	std::filesystem::remove(entry, err);
+	if (err) {
+		RavenLogWarning("Failed to remove {}: {}", entry.string(), err.message());
+	}
+}
+
+void CSkinCache::Save() {
+	if (!m_manifest.Save())
+		return;
+	// Entries are named {hash}.{level}.tga
+	std::error_code err;
+	for (const auto& entry : std::filesystem::directory_iterator{m_directory, err}) {
+		if (entry.path().extension() != ".tga")
+			continue;
+		const auto name = entry.path().filename().string();
+		uint64     hash = 0;
+		const auto [pEnd, ec] =
+			std::from_chars(name.data(), name.data() + name.size(), hash, 16);
+		if (ec != std::errc{} || *pEnd != '.' || !m_manifest.HasHash(hash))
+			Remove(entry.path());
+	}
+}
+} // namespace OSU
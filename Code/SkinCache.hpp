@@ -0,0 +1,36 @@
+#pragma once
+#include "HashManifest.hpp"
+
+#include <filesystem>
+
+namespace OSU {
+//! Skin textures kept decoded on disk so loading a skin skips PNG decoding.
+//! Entries are keyed by a hash of the source file, see CHashManifest.
+//! Editing, replacing or deleting a skin file makes its entries stale, they
+//! are removed on the next Save.
+class CSkinCache {
+  public:
+	explicit CSkinCache(std::filesystem::path directory);
+
+	//! Path of the decoded copy of `source`. Level n is downscaled by 2^n, like
+	//! a mip level. Empty if the source is missing or could not be decoded.
+	std::optional<std::string> GetOrCreate(const std::filesystem::path& source,
+										   uint32 level = 0);
+
+	//! Deletes an entry that turned out unreadable, the next GetOrCreate
+	//! writes it again
+	void Remove(const std::filesystem::path& entry);
+
+	//! Persists the manifest if any source changed since the last save and
+	//! removes the entries no source maps to anymore
+	void Save();
+
+  private:
+	std::filesystem::path m_directory;
+	CHashManifest         m_manifest;
+};
+
+struct SkinCache {
+	std::shared_ptr<CSkinCache> Cache;
+};
+} // namespace OSU
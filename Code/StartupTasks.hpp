@@ -0,0 +1,143 @@
+#pragma once
+#include <RavenApp/RavenApp.hpp>
+#include "GameClock.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace OSU {
+//! Loading work that overlaps the splash screen. Plugins add tasks while they
+//! are built, Start runs the Work of every task on worker threads as soon as
+//! its dependencies are done. Finish steps run on the main thread from Poll,
+//! in the order the tasks were added, and move the results into resources.
+class CStartupTasks {
+  public:
+	CStartupTasks() : m_startTime(GetMonotonicTimeMs()) {}
+
+	~CStartupTasks() {
+		for (auto& worker : m_workers)
+			worker.request_stop();
+		m_wakeUp.notify_all();
+	}
+
+	CStartupTasks(const CStartupTasks&)            = delete;
+	CStartupTasks& operator=(const CStartupTasks&) = delete;
+
+	//! Dependencies are names of tasks added before this one. Work runs next to
+	//! other tasks, assets are loaded through LoadAsset.
+	void Add(std::string name, std::function<void()> work, std::function<void()> finish = {},
+			 const std::initializer_list<std::string_view> dependencies = {}) {
+		RavenAssert(m_workers.empty(), "Startup tasks were already started!");
+		auto& task  = m_tasks.emplace_back();
+		task.Name   = std::move(name);
+		task.Work   = std::move(work);
+		task.Finish = std::move(finish);
+		for (const auto dependency : dependencies) {
+			const auto it = std::find_if(std::begin(m_tasks), std::end(m_tasks) - 1,
+										 [&](const Task& t) { return t.Name == dependency; });
+			RavenAssert(it != std::end(m_tasks) - 1, "Unknown startup task dependency!");
+			task.Dependencies.emplace_back(static_cast<uint32>(it - std::begin(m_tasks)));
+		}
+	}
+
+	void Start(const uint32 workerCount = std::max(std::thread::hardware_concurrency() / 2, 1u)) {
+		if (!m_workers.empty())
+			return;
+		for (uint32 i = 0; i < std::min(workerCount, static_cast<uint32>(m_tasks.size())); ++i) {
+			m_workers.emplace_back([this](std::stop_token stop) { Run(stop); });
+		}
+	}
+
+	//! Runs the Finish steps that are ready, true once every task finished
+	bool Poll() {
+		if (m_loadedTime > 0.0)
+			return true;
+		for (auto& task : m_tasks) {
+			if (task.IsFinished)
+				continue;
+			if (!task.IsDone.load(std::memory_order_acquire))
+				return false; // Finish steps keep the order tasks were added in
+			if (task.Finish)
+				task.Finish();
+			task.IsFinished = true;
+			RavenLogInfo("Startup task {} took {:.1f}ms", task.Name, task.DurationMs);
+		}
+		m_loadedTime = GetMonotonicTimeMs();
+		return true;
+	}
+
+	double GetStartTime() const { return m_startTime; }
+	//! Time every task finished at, 0 while loading
+	double GetLoadedTime() const { return m_loadedTime; }
+
+  private:
+	struct Task {
+		std::string           Name;
+		std::function<void()> Work;
+		std::function<void()> Finish;
+		std::vector<uint32>   Dependencies;
+		bool                  IsStarted  = false; // Guarded by m_mutex
+		std::atomic<bool>     IsDone{false};
+		bool                  IsFinished = false; // Main thread only
+		double                DurationMs = 0.0;
+	};
+
+	Task* NextReady() {
+		for (auto& task : m_tasks) {
+			if (task.IsStarted)
+				continue;
+			const bool isReady = std::ranges::all_of(task.Dependencies, [&](const uint32 idx) {
+				return m_tasks[idx].IsDone.load(std::memory_order_acquire);
+			});
+			if (isReady)
+				return &task;
+		}
+		return nullptr;
+	}
+
+	void Run(std::stop_token stop) {
+		while (!stop.stop_requested()) {
+			Task* pTask = nullptr;
+			{
+				std::unique_lock lock{m_mutex};
+				const bool isWoken = m_wakeUp.wait(lock, stop, [&] {
+					pTask = NextReady();
+					return pTask != nullptr || std::ranges::all_of(m_tasks, [](const Task& t) {
+							   return t.IsStarted;
+						   });
+				});
+				if (!isWoken || !pTask)
+					return; // Stopped or nothing left to start
+				pTask->IsStarted = true;
+			}
+
+			const double start = GetMonotonicTimeMs();
+			if (pTask->Work)
+				pTask->Work();
+			pTask->DurationMs = GetMonotonicTimeMs() - start;
+			{
+				std::scoped_lock lock{m_mutex};
+				pTask->IsDone.store(true, std::memory_order_release);
+			}
+			m_wakeUp.notify_all();
+		}
+	}
+
+	std::deque<Task>            m_tasks; // Stable addresses, tasks hold an atomic
+	std::mutex                  m_mutex;
+	std::condition_variable_any m_wakeUp;
+	double                      m_startTime  = 0.0; // Monotonic ms
+	double                      m_loadedTime = 0.0;
+	std::vector<std::jthread>   m_workers; // Last, joined before the tasks die
+};
+
+struct StartupTasks {
+	std::shared_ptr<CStartupTasks> Tasks = std::make_shared<CStartupTasks>();
+	bool IsInteractive = false; // Set by the first menu frame
+};
+} // namespace OSU
@@ -1,18 +1,28 @@
 #include "UICommon.hpp"
 
 #include "RavenOSU.hpp"
+#include "AsyncAssets.hpp"
+#include "GameClock.hpp"
+#include "SongIndex.hpp"
+#include "StartupTasks.hpp"
+#include "ThumbnailCache.hpp"
 #include <Events/SystemEvents.hpp>
 #include <RavenFont/Font.hpp>
 #include <RavenAudio/RavenAudio.hpp>
 #include <IInput.h>
 
 #include <filesystem>
+#include <future>
 
 namespace OSU::UI {
 using namespace Raven;
 using namespace Raven::UI;
 struct MenuRoot {};
-struct SongSelect { std::string Path; std::string BGImage; };
+struct SongSelect {
+	std::string Path;
+	std::string BGImage;
+	uint32      Index = 0; // Entry of the SongLibrary index
+};
 
 struct PreviewImage {
 	Handle<CImage> Image;
@@ -22,10 +32,129 @@ struct UIState {
 	TEntity PreviewPlayer{};
 };
 
+//! Assets of the hovered song that are still being loaded. The audio and
+//! background are requested once the beatmap header is known.
+struct PendingPreview {
+	TAssetFuture<CBeatmap>     Beatmap;
+	TAssetFuture<Audio::Sound> Sound;
+	TAssetFuture<CImage>       Background;
+	bool                       IsMediaRequested = false;
+	double                     HoverTime        = 0.0; // Monotonic ms
+	bool                       IsPrefetched     = false;
+	// Loads borrowed from SongPrefetcher, which cancels them itself
+	bool IsBeatmapShared    = false;
+	bool IsSoundShared      = false;
+	bool IsBackgroundShared = false;
+
+	void Cancel() {
+		if (!IsBeatmapShared)
+			Beatmap.Cancel();
+		if (!IsSoundShared)
+			Sound.Cancel();
+		if (!IsBackgroundShared)
+			Background.Cancel();
+	}
+};
+
+//! Song that was clicked, the game starts once beatmap and audio are loaded
+struct PendingSong {
+	TAssetFuture<CBeatmap>     Beatmap;
+	TAssetFuture<Audio::Sound> Sound;
+};
+
+//! Every .osu file found under Assets/Songs. Visible holds the entries that
+//! match the search, in the selected sort order, and backs the song list.
+struct SongLibrary {
+	CSongIndex              Index;
+	std::vector<uint32>     Visible;
+	std::string             Query;
+	ESongSort               Sort = ESongSort::Title;
+	std::future<CSongIndex> Rescan; // Of an empty library, see SpawnListItems
+};
+
+struct SearchText {};
+
+//! Background music of the menu, loaded during startup. Requested again if
+//! that failed, the menu stays silent until it arrives.
+struct MenuMusic {
+	Handle<Audio::Sound>       Sound;
+	TAssetFuture<Audio::Sound> Pending;
+	bool                       IsFailed = false; // Not requested again
+};
+
+//! Warms beatmap headers, backgrounds and audio of the rows around the hovered
+//! one with low priority loads. Rows that leave the window are cancelled.
+struct SongPrefetcher {
+	static constexpr uint32 Radius      = 3; // Rows on each side
+	static constexpr uint32 AudioRadius = 1; // Decoded audio is large
+
+	struct Entry {
+		TAssetFuture<CBeatmap>     Beatmap;
+		TAssetFuture<CImage>       Background;
+		TAssetFuture<Audio::Sound> Sound;
+		bool                       IsMediaRequested = false;
+	};
+
+	const Entry* Find(const uint32 index) const {
+		const auto it = Entries.find(index);
+		return it != std::end(Entries) ? &it->second : nullptr;
+	}
+
+	std::unordered_map<uint32, Entry> Entries; // By SongSelect::Index
+	uint32                            Centre = 0; // Row in SongLibrary::Visible
+	bool IsSettled = false; // Every load of the window was issued, cleared on hover
+};
+
+//! Time from hovering a song until its preview starts playing
+struct PreviewLatency {
+	uint32 Samples      = 0;
+	uint32 PrefetchHits = 0;
+	double TotalMs      = 0.0;
+	double MaxMs        = 0.0;
+
+	void Record(const double ms, const bool isPrefetched) {
+		++Samples;
+		PrefetchHits += isPrefetched;
+		TotalMs += ms;
+		MaxMs = std::max(MaxMs, ms);
+	}
+};
+
+struct PreviewFade {
+	static constexpr float Duration = 300.f; // ms
+	float Elapsed = 0.f;
+};
+
+//! Appearance the menu backdrop was last updated with, the defaults force the
+//! first update
+struct AppliedAppearance {
+	float BGDim       = -1.f;
+	float AudioVolume = -1.f;
+};
+
+//! Change driven menu systems that found nothing to do. Skipped is counted
+//! during a frame and folded into the totals by BeginMenuFrame.
+struct MenuSystemStats {
+	uint32 Skipped      = 0;
+	uint32 MaxSkipped   = 0;
+	uint64 TotalSkipped = 0;
+	uint32 Frames       = 0;
+
+	void Skip() { ++Skipped; }
+};
+
+constexpr std::string_view MenuMusicPath = "project://Assets/Audio/BackgroundAudio.mp3";
+
 namespace Detail {
 	template<typename FnT> void ForEachSong(FnT f) {
 		const auto songsPath = SAssetManager::ResolvePath(App::Get(), "project://Assets/Songs");
-		std::filesystem::recursive_directory_iterator iter{songsPath.m_absolutePath};
+		// Runs on a worker, a missing directory must not throw
+		std::error_code err;
+		std::filesystem::recursive_directory_iterator iter{songsPath.m_absolutePath, err};
+		if (err) {
+			RavenLogWarning("Failed to scan songs: {}", err.message());
+			return;
+		}
 		for(auto dir: iter) {
 			if(dir.is_directory())
 				continue;
@@ -35,6 +164,16 @@ namespace Detail {
 			f(p);
 		}
 	}
+
+	CSongIndex ScanSongs() {
+		std::vector<SongEntry> entries;
+		ForEachSong([&](std::filesystem::path path) {
+			entries.emplace_back(SongEntry::Read(path));
+		});
+		CSongIndex index;
+		index.Build(std::move(entries));
+		return index;
+	}
 }
 
 TEntity SpawnSlider(CWorld& world, const TEntity& parent, const char* name) {
@@ -58,6 +197,7 @@ TEntity SpawnSlider(CWorld& world, const TEntity& parent, const char* name) {
 	});
 	world.AddComponent<Button>(hSlider);
 	world.AddComponent<Slider>(hSlider);
+	world.AddComponent<DirtySlider>(hSlider);
 	world.AddChild(hSliderRoot, hSlider);
 
 	return hSliderRoot;
@@ -65,16 +205,62 @@ TEntity SpawnSlider(CWorld& world, const TEntity& parent, const char* name) {
 
 void UpdateScrollList(
 	const Events<Event::System::SMouseScroll>& events,
-	const Query<With<ScrollList, Style, Interaction>>&
-		interactedLists) {
+	const Query<With<ScrollList, Interaction>>& interactedLists) {
 	for(const auto& e: events) {
 		for(auto hList: interactedLists) {
-			auto& list  = interactedLists.get<ScrollList>(hList);
-			auto& style = interactedLists.get<Style>(hList);
-			list.ScrollOffset += e.yOffset * 100.f;
-			style.padding.Top = Dimension::Px(list.ScrollOffset);
+			interactedLists.get<ScrollList>(hList).Velocity +=
+				e.yOffset * ScrollList::Impulse;
+		}
+	}
+}
+
+void IntegrateScrollLists(CWorld& world, const CTimestep& ts, MenuSystemStats& stats,
+						  const Query<With<ScrollList, SParentComponent>>& lists) {
+	const float dt        = ts.GetMilliseconds() / 1000.f;
+	bool        isWritten = false;
+	for (auto hList : lists) {
+		auto& list = lists.get<ScrollList>(hList);
+		if (list.Velocity != 0.f) {
+			list.ScrollOffset += list.Velocity * dt;
+			list.Velocity *= std::exp(-ScrollList::Friction * dt);
+			if (std::abs(list.Velocity) < 1.f)
+				list.Velocity = 0.f;
+		}
+
+		float translation = list.ScrollOffset;
+		if (world.Has<VirtualList>(hList)) {
+			// Whole rows are handled by rebinding the pool, the translation
+			// places slot 0 at its item so the layout never changes
+			auto& virt = world.GetComponent<VirtualList>(hList);
+			const float maxOffset =
+				std::max(static_cast<float>(virt.ItemCount) - 1.f, 0.f) * virt.RowHeight;
+			if (list.ScrollOffset < -maxOffset || list.ScrollOffset > 0.f) {
+				list.ScrollOffset = std::clamp(list.ScrollOffset, -maxOffset, 0.f);
+				list.Velocity     = 0.f;
+			}
+			const auto topItem =
+				static_cast<uint32>(-list.ScrollOffset / virt.RowHeight);
+			if (topItem != virt.TopItem) {
+				const auto firstItem = topItem - std::min(topItem, VirtualList::Margin);
+				virt.IsDirty   = virt.IsDirty || firstItem != virt.FirstItem;
+				virt.FirstItem = firstItem;
+				virt.TopItem   = topItem;
+			}
+			translation = list.ScrollOffset + static_cast<float>(virt.FirstItem) * virt.RowHeight;
+		}
+
+		if (list.AppliedTranslation == translation)
+			continue;
+		list.AppliedTranslation = translation;
+		isWritten               = true;
+		auto next = lists.get<SParentComponent>(hList).first;
+		while (next) {
+			world.GetComponent<STransformComponent>(next).m_translation.y = translation;
+			next = world.GetComponent<SHierarchyComponent>(next).next;
 		}
 	}
+	if (!isWritten)
+		stats.Skip();
 }
 
 void RemoveDrags(
@@ -114,7 +300,7 @@ void UpdateDrag(CWorld&                                      world,
 	}
 }
 
-void UpdateSliderValue(const Events<Event::System::SMouseMove>&       events,
+void UpdateSliderValue(CWorld& world, const Events<Event::System::SMouseMove>& events,
 	const Query<With<DragInteraction, Slider, Style, SComputedLayout, SHierarchyComponent>>& sliders,
 	const Query<With<SComputedLayout>>& layouts) {
 	for(const auto& e: events) {
@@ -133,10 +319,14 @@ void UpdateSliderValue(const Events<Event::System::SMouseMove>&       events,
 				const float2 availableSpace =
 					sliderLayout.size - handleLayout.size;
 
-				s.Value += drag.Delta.x / (availableSpace.x);
-				s.Value = std::clamp(s.Value, s.From, s.To);
+				const float value = std::clamp(
+					s.Value + drag.Delta.x / (availableSpace.x), s.From, s.To);
+				if (value == s.Value)
+					return;
+				s.Value = value;
 				if (s.OnChange)
 					s.OnChange(s.Value);
+				world.AddOrReplace<DirtySlider>(ent);
 			});
 
 		});
@@ -144,55 +334,262 @@ void UpdateSliderValue(const Events<Event::System::SMouseMove>&       events,
 }
 
 void UpdateSliderHandle(
-	const Query<With<Slider, Style, SComputedLayout,
-					 SHierarchyComponent /*,Updated<Slider>*/>>& sliders,
+	CWorld& world, MenuSystemStats& stats,
+	const Query<With<DirtySlider, Slider, Style, SComputedLayout, SHierarchyComponent>>& sliders,
 	const Query<With<SComputedLayout>>& layouts) {
-	sliders.each([&](Slider& slider, Style& style, SComputedLayout& handleLayout,
-					 const SHierarchyComponent& hierarchy) {
-		const auto& sliderLayout =
-			layouts.get<SComputedLayout>(hierarchy.parentId);
-		const float2 availableSpace = sliderLayout.size - handleLayout.size;
-		style.position.Left         = Dimension::Pc(
-					std::min((slider.Value - slider.From) / (slider.To - slider.From),
-							 availableSpace.x / sliderLayout.size.x));
-	});
+	if (sliders.begin() == sliders.end()) {
+		stats.Skip();
+		return;
+	}
+	for (auto hSlider : sliders) {
+		const auto& sliderLayout = layouts.get<SComputedLayout>(
+			sliders.get<SHierarchyComponent>(hSlider).parentId);
+		if (sliderLayout.size.x <= 0.f)
+			continue; // Not laid out yet
+		const auto&  slider         = sliders.get<Slider>(hSlider);
+		const float2 availableSpace =
+			sliderLayout.size - sliders.get<SComputedLayout>(hSlider).size;
+		sliders.get<Style>(hSlider).position.Left = Dimension::Pc(
+			std::min((slider.Value - slider.From) / (slider.To - slider.From),
+					 availableSpace.x / sliderLayout.size.x));
+		world.RemoveComponent<DirtySlider>(hSlider);
+	}
+}
+
+//! Menu backgrounds come from the thumbnail cache, only gameplay loads the
+//! full resolution image
+TAssetFuture<CImage> LoadBackgroundThumbnail(
+	CAsyncAssets& assets, const ThumbnailCache& thumbnails, const CBeatmap& beatmap,
+	const ELoadPriority priority = ELoadPriority::Normal) {
+	if (beatmap.GetBackground().empty())
+		return {};
+	return assets.LoadWith<CImage>(
+		[cache  = thumbnails.Cache,
+		 source = std::filesystem::path{beatmap.GetBackground()}] {
+			return cache->GetOrCreate(source);
+		},
+		priority);
+}
+
+std::string FormatSearch(const SongLibrary& library) {
+	return fmt::format("{} [{}]", library.Query.empty() ? "Type to search" : library.Query,
+					   ToString(library.Sort));
+}
+
+// The whole pool exists regardless of how many songs are visible, the query
+// can change while the menu is closed. Rows are bound to songs and spare
+// ones hidden by BindSongRows.
+void SpawnListRows(CWorld& world, const Appearance& appearance, const TEntity hList) {
+	for (uint32 slot = 0; slot < VirtualList::PoolSize; ++slot) {
+		world
+			.GetComponent<Style>(Widgets::SpawnButton(
+				world, hList, SColourF::Black(0.f), appearance.Font, "",
+				Tags::NoSerialise{}, Tags::NoCopy{}, SongSelect{},
+				ListRow{.Slot = slot}))
+			.Flex(0.f, 0.f);
+	}
 }
 
 void SpawnListItems(
-	CWorld& world, const Appearance& appearance,
+	CWorld& world, const Appearance& appearance, SongLibrary& library,
+	SongPrefetcher& prefetcher, MenuSystemStats& stats,
 	const Query<With<Initialised<ScrollList>, ScrollList>>& lists) {
+	if (lists.begin() == lists.end()) {
+		stats.Skip();
+		return;
+	}
 	for(auto hList: lists) {
-		Detail::ForEachSong([&](std::filesystem::path path) {
-			world
-				.GetComponent<Style>(Widgets::SpawnButton(
-					world, hList, SColourF::Black(0.1f), appearance.Font,
-					path.filename().stem().string(), Tags::NoSerialise{},
-					Tags::NoCopy{},
-					SongSelect{
-						.Path = path.string(),
-					}))
-				.Flex(0.f, 0.f);
-		});
+		prefetcher = SongPrefetcher{};
+		// Scanned during startup, the query and sort survive reopening the menu.
+		// An empty library is scanned again off the main thread in case songs
+		// were added, FinishSongRescan fills the list once it completed.
+		if (library.Index.GetSize() == 0 && !library.Rescan.valid()) {
+			library.Rescan = std::async(std::launch::async, &Detail::ScanSongs);
+		}
+
+		const auto count = static_cast<uint32>(library.Visible.size());
+		world.AddComponent<VirtualList>(hList, VirtualList{.ItemCount = count});
+		SpawnListRows(world, appearance, hList);
+		lists.get<ScrollList>(hList).AppliedTranslation.reset(); // New rows start at 0
+	}
+}
+
+// The library was empty when the lists were spawned, so no row is bound yet
+void FinishSongRescan(SongLibrary& library, SongPrefetcher& prefetcher, MenuSystemStats& stats,
+					  const Query<With<VirtualList, ScrollList>>& lists) {
+	if (!library.Rescan.valid() ||
+		library.Rescan.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+		stats.Skip();
+		return;
+	}
+	library.Index = library.Rescan.get();
+	library.Index.Search(library.Query, library.Sort, library.Visible);
+	prefetcher.IsSettled = false;
+	const auto count     = static_cast<uint32>(library.Visible.size());
+	for (auto hList : lists) {
+		auto& virt     = lists.get<VirtualList>(hList);
+		virt.ItemCount = count;
+		virt.IsDirty   = true;
+	}
+}
+
+void ClearPreview(CWorld& world, const TEntity hSel) {
+	if (world.Has<PendingPreview>(hSel)) {
+		world.GetComponent<PendingPreview>(hSel).Cancel();
+		world.RemoveComponent<PendingPreview>(hSel);
+	}
+	if (world.Has<PreviewFade>(hSel)) {
+		world.RemoveComponent<PreviewFade>(hSel);
+	}
+	if (world.Has<Audio::Player>(hSel)) {
+		world.RemoveComponent<Audio::Player>(hSel);
+	}
+	if (world.Has<PreviewImage>(hSel)) {
+		world.RemoveComponent<PreviewImage>(hSel);
+	}
+}
+
+// A row rebound under the cursor keeps its Interaction, its preview is
+// dropped and the new song previews once it is hovered again.
+void BindSongRows(CWorld& world, const SongLibrary& library, MenuSystemStats& stats,
+				  const Query<With<VirtualList, ScrollList>>&                 lists,
+				  const Query<With<ListRow, SongSelect, SParentComponent>>& rows) {
+	bool isBinding = false;
+	for (auto hList : lists) {
+		auto& virt = lists.get<VirtualList>(hList);
+		if (!virt.IsDirty)
+			continue;
+		virt.IsDirty = false;
+		isBinding    = true;
+
+		for (auto hRow : rows) {
+			const auto row     = virt.FirstItem + rows.get<ListRow>(hRow).Slot;
+			const bool isBound = row < library.Visible.size();
+			const auto index   = isBound ? library.Visible[row] : 0u;
+			auto&      song    = rows.get<SongSelect>(hRow);
+			if (isBound && song.Index == index && !song.Path.empty())
+				continue;
+
+			ClearPreview(world, hRow);
+			auto& text = world.GetComponent<Text>(rows.get<SParentComponent>(hRow).first).text;
+			auto& colour = world.GetComponent<Style>(hRow).colour;
+			if (!isBound) {
+				song   = SongSelect{};
+				colour = SColourF::Black(0.f); // Spare slot
+				text.clear();
+				continue;
+			}
+			colour = SColourF::Black(0.1f);
+			const auto& entry = library.Index.Get(index);
+			song = SongSelect{.Path = entry.Path, .Index = index};
+			text = entry.Artist.empty()
+					   ? entry.Title
+					   : fmt::format("{} - {} [{}]", entry.Artist, entry.Title, entry.Version);
+		}
 	}
+	if (!isBinding)
+		stats.Skip();
 }
 
-void SpawnSongList(CWorld& world, const Query<With<Initialised<MenuRoot>>>& menus) {
+void SpawnSongList(CWorld& world, const Appearance& appearance,
+				   const SongLibrary& library, MenuSystemStats& stats,
+				   const Query<With<Initialised<MenuRoot>>>& menus) {
+	if (menus.begin() == menus.end()) {
+		stats.Skip();
+		return;
+	}
 	for(auto hMenu: menus) {
-		auto hList   = Widgets::UINode(world, "SongList", Style {
-			.colour  = {0.8f, 0.1f, 0.1f, 0.8f},
+		auto hColumn = Widgets::UINode(world, "SongColumn", Style {
 			.margin  = Rect{.Right = 2_pc},
 			.size    = Size::Width(40_pc),
 			.maxSize = Size::Width(40_pc),
 			.eDirection = EFlexDirection::Column,
 		});
-		world.AddChild(hMenu, hList);
+		world.AddChild(hMenu, hColumn);
+
+		UIBuilder{hColumn, world}
+			.Text(FormatSearch(library), appearance.Font, SColourF::White())
+			.WithComponent<SearchText>()
+			.Style()
+			.Size(Size::Height(5_pc));
+
+		auto hList   = Widgets::UINode(world, "SongList", Style {
+			.colour  = {0.8f, 0.1f, 0.1f, 0.8f},
+			.flexGrow = 1.f,
+			.eDirection = EFlexDirection::Column,
+		});
+		world.AddChild(hColumn, hList);
 		world.AddComponent<ScrollList>(hList);
 		world.AddComponent<Button>(hList); // For interaction
 	}
 }
 
-void SpawnSettings(CWorld& world, Appearance& appearance,
+// Typing filters the song list, Backspace and Escape edit the query and Tab
+// cycles through the sort orders.
+void UpdateSongSearch(const Events<Event::System::SKeyPress>&            events,
+					  SongLibrary& library, SongPrefetcher& prefetcher,
+					  const Query<With<VirtualList, ScrollList>>&        lists,
+					  const Query<With<SearchText, Text>>&               texts) {
+	if (lists.begin() == lists.end())
+		return;
+
+	bool isChanged = false;
+	for (const auto& e : events) {
+		if (e.eKeyAction != EKeyAction::Press)
+			continue;
+		switch (e.ePressedKey) {
+		case EKey::Backspace:
+			if (!library.Query.empty())
+				library.Query.pop_back();
+			break;
+		case EKey::Escape:
+			library.Query.clear();
+			break;
+		case EKey::Space:
+			library.Query.push_back(' ');
+			break;
+		case EKey::Tab:
+			library.Sort = static_cast<ESongSort>(
+				(static_cast<uint8>(library.Sort) + 1) % static_cast<uint8>(ESongSort::Count));
+			break;
+		default: {
+			const std::string_view name = KeyToString(e.ePressedKey);
+			if (name.size() != 1 || !std::isalnum(static_cast<unsigned char>(name[0])))
+				continue;
+			library.Query.push_back(
+				static_cast<char>(std::tolower(static_cast<unsigned char>(name[0]))));
+			break;
+		}
+		}
+		isChanged = true;
+	}
+	if (!isChanged)
+		return;
+
+	library.Index.Search(library.Query, library.Sort, library.Visible);
+	prefetcher.IsSettled = false;
+	for (auto hList : lists) {
+		auto& virt     = lists.get<VirtualList>(hList);
+		virt.ItemCount = static_cast<uint32>(library.Visible.size());
+		virt.FirstItem = 0;
+		virt.TopItem   = 0;
+		virt.IsDirty   = true;
+
+		auto& list        = lists.get<ScrollList>(hList);
+		list.ScrollOffset = 0.f;
+		list.Velocity     = 0.f;
+	}
+	for (auto hText : texts) {
+		texts.get<Text>(hText).text = FormatSearch(library);
+	}
+}
+
+void SpawnSettings(CWorld& world, Appearance& appearance, MenuSystemStats& stats,
 				   const Query<With<Initialised<MenuRoot>>>& menus) {
+	if (menus.begin() == menus.end()) {
+		stats.Skip();
+		return;
+	}
 	for (auto hMenu : menus) {
 		auto settingWnd =
 			UIBuilder(hMenu, world)
@@ -240,77 +637,264 @@ void SpawnSettings(CWorld& world, Appearance& appearance,
 	}
 }
 
-void AddPreview(CWorld& world, App& app, SAssetManager& mgr,
+// Reuses a prefetched load, one still waiting in the low priority queue is
+// moved to the normal one rather than loading the file a second time
+template <typename T, typename FnT>
+TAssetFuture<T> ReusePrefetched(CAsyncAssets& assets, const TAssetFuture<T>& prefetched,
+								FnT load) {
+	if (!prefetched.IsValid())
+		return load();
+	assets.Prioritise(prefetched);
+	return prefetched;
+}
+
+void AddPreview(CWorld& world, const AsyncAssets& assets,
+				const SongPrefetcher& prefetcher,
 				const Query<With<Initialised<Interaction>, SongSelect>,
-							WithOut<Audio::Player>>& selected,
-				const Assets<CBeatmap>&              beatmaps) {
+							WithOut<Audio::Player>>& selected) {
 	for (auto& hSel : selected) {
-		const auto& song     = selected.get<SongSelect>(hSel);
+		const auto& song   = selected.get<SongSelect>(hSel);
+		if (song.Path.empty())
+			continue; // Unbound pool row
+		const auto* pEntry   = prefetcher.Find(song.Index);
+		const auto  prefetch = pEntry ? pEntry->Beatmap : TAssetFuture<CBeatmap>{};
+		world.AddOrReplace<PendingPreview>(
+			hSel, PendingPreview{
+					  .Beatmap = ReusePrefetched(*assets.Loader, prefetch,
+												 [&] {
+													 return assets.Loader->Load<CBeatmap>(
+														 song.Path);
+												 }),
+					  .HoverTime       = GetMonotonicTimeMs(),
+					  .IsBeatmapShared = prefetch.IsValid(),
+				  });
+	}
+}
 
-		const auto* pBeatmap = beatmaps.Get(
-			mgr.Load(app, song.Path).OnSuccess().Typed<CBeatmap>());
+// Beatmaps without a preview point (-1) start 40% in, like osu! does
+int GetPreviewTime(const CBeatmap& beatmap) {
+	const int previewTime = beatmap.GetGeneral().PreviewTime;
+	if (previewTime >= 0)
+		return previewTime;
+	const auto hitObjects = beatmap.GetHitObjects();
+	return hitObjects.empty() ? 0 : hitObjects.back().Time * 2 / 5;
+}
 
-		if (!pBeatmap)
+void ResolvePreview(CWorld& world, const AsyncAssets& assets,
+					const ThumbnailCache& thumbnails,
+					const SongPrefetcher& prefetcher, PreviewLatency& latency,
+					const Assets<CBeatmap>&                        beatmaps,
+					const Query<With<PendingPreview, SongSelect>>& pending) {
+	for (auto hSel : pending) {
+		auto& preview = pending.get<PendingPreview>(hSel);
+		if (!preview.IsMediaRequested) {
+			if (!preview.Beatmap.IsReady())
+				continue;
+			const auto* pBeatmap = beatmaps.Get(preview.Beatmap.Get());
+			if (!pBeatmap) {
+				world.RemoveComponent<PendingPreview>(hSel);
+				continue;
+			}
+			const auto* pEntry =
+				prefetcher.Find(pending.get<SongSelect>(hSel).Index);
+			const SongPrefetcher::Entry entry = pEntry ? *pEntry : SongPrefetcher::Entry{};
+			preview.IsPrefetched       = entry.Sound.IsReady();
+			preview.IsSoundShared      = entry.Sound.IsValid();
+			preview.IsBackgroundShared = entry.Background.IsValid();
+			preview.Sound = ReusePrefetched(*assets.Loader, entry.Sound, [&] {
+				return assets.Loader->Load<Audio::Sound>(std::string{pBeatmap->GetSongPath()});
+			});
+			preview.Background = ReusePrefetched(*assets.Loader, entry.Background, [&] {
+				return LoadBackgroundThumbnail(*assets.Loader, thumbnails, *pBeatmap);
+			});
+			preview.IsMediaRequested = true;
+		}
+
+		if (preview.Background.IsReady()) {
+			if (const auto hImage = preview.Background.Get()) {
+				world.AddOrReplace<PreviewImage>(hSel, hImage);
+			}
+			preview.Background = {};
+		}
+
+		if (preview.Sound.IsReady()) {
+			if (const auto hSound = preview.Sound.Get()) {
+				auto& player = world.AddComponent<Audio::Player>(
+					hSel, Audio::Player{.Sound         = hSound,
+										.PlaybackSpeed = 1.f,
+										.Volume        = 0.f,
+										.IsLooping     = true,
+										.IsPlaying     = true});
+				// Set before the audio system first sees the player
+				player.PlayingTime = GetPreviewTime(*beatmaps.Get(preview.Beatmap.Get()));
+				world.AddComponent<PreviewFade>(hSel);
+				latency.Record(GetMonotonicTimeMs() - preview.HoverTime,
+							   preview.IsPrefetched);
+			}
+			preview.Sound = {};
+		}
+
+		if (!preview.Sound.IsValid() && !preview.Background.IsValid()) {
+			world.RemoveComponent<PendingPreview>(hSel);
+		}
+	}
+}
+
+void PrefetchNeighbours(
+	const AsyncAssets& assets, const ThumbnailCache& thumbnails,
+	const SongLibrary& library,
+	SongPrefetcher&                                          prefetcher,
+	MenuSystemStats&                                         stats,
+	const Assets<CBeatmap>&                                  beatmaps,
+	const Query<With<VirtualList>>&                          lists,
+	const Query<With<Initialised<Interaction>, SongSelect, ListRow>>& hovered) {
+	for (auto hList : lists) {
+		for (auto hSel : hovered) {
+			if (hovered.get<SongSelect>(hSel).Path.empty())
+				continue;
+			prefetcher.Centre    = lists.get<VirtualList>(hList).FirstItem +
+								   hovered.get<ListRow>(hSel).Slot;
+			prefetcher.IsSettled = false;
+		}
+	}
+	const auto count = static_cast<uint32>(library.Visible.size());
+	if (prefetcher.IsSettled || count == 0) {
+		stats.Skip();
+		return;
+	}
+	const uint32 first = prefetcher.Centre - std::min(prefetcher.Centre, SongPrefetcher::Radius);
+	const uint32 last  = std::min(prefetcher.Centre + SongPrefetcher::Radius, count - 1);
+	if (first > last)
+		return; // The search shrank the list below the last hover
+
+	std::erase_if(prefetcher.Entries, [&](auto& entry) {
+		const auto inWindow = std::find(std::begin(library.Visible) + first,
+										std::begin(library.Visible) + last + 1, entry.first);
+		if (inWindow != std::begin(library.Visible) + last + 1)
+			return false;
+		entry.second.Beatmap.Cancel();
+		entry.second.Background.Cancel();
+		entry.second.Sound.Cancel();
+		return true;
+	});
+
+	// Polled until every beatmap of the window resolved and its media was requested
+	bool isSettled = true;
+	for (uint32 i = first; i <= last; ++i) {
+		if (i == prefetcher.Centre)
+			continue; // Loaded by AddPreview at normal priority
+		auto& entry = prefetcher.Entries[library.Visible[i]];
+		if (!entry.Beatmap.IsValid()) {
+			// Refused while the low priority queue is full, retried next frame
+			entry.Beatmap = assets.Loader->Load<CBeatmap>(
+				library.Index.Get(library.Visible[i]).Path, ELoadPriority::Low);
+			isSettled = false;
 			continue;
+		}
+		if (entry.IsMediaRequested)
+			continue;
+		if (!entry.Beatmap.IsReady()) {
+			isSettled = false;
+			continue;
+		}
+		const auto* pBeatmap = beatmaps.Get(entry.Beatmap.Get());
+		if (!pBeatmap) {
+			entry.IsMediaRequested = true; // Nothing to request
+			continue;
+		}
+		// Loads refused while the low priority queue is full are retried
+		const bool hasBackground = !pBeatmap->GetBackground().empty();
+		if (hasBackground && !entry.Background.IsValid()) {
+			entry.Background = LoadBackgroundThumbnail(*assets.Loader, thumbnails,
+													   *pBeatmap, ELoadPriority::Low);
+		}
+		const uint32 distance = i > prefetcher.Centre ? i - prefetcher.Centre
+													  : prefetcher.Centre - i;
+		const bool   hasSound = distance <= SongPrefetcher::AudioRadius;
+		if (hasSound && !entry.Sound.IsValid()) {
+			entry.Sound = assets.Loader->Load<Audio::Sound>(
+				std::string{pBeatmap->GetSongPath()}, ELoadPriority::Low);
+		}
+		entry.IsMediaRequested = (!hasBackground || entry.Background.IsValid()) &&
+								 (!hasSound || entry.Sound.IsValid());
+		isSettled = isSettled && entry.IsMediaRequested;
+	}
+	prefetcher.IsSettled = isSettled;
+}
 
-		auto hSong = mgr.Load(app, pBeatmap->GetSongPath())
-						 .OnSuccess()
-						 .Typed<Audio::Sound>();
-
-		world.AddComponent<Audio::Player>(hSel,
-										  Audio::Player{.Sound         = hSong,
-														.PlaybackSpeed = 1.f,
-														.Volume        = 1.f,
-														.IsLooping     = true,
-														.IsPlaying     = true});
-		const auto bgImage = LoadBackgroundImage(app, mgr, *pBeatmap);
-		if (bgImage) {
-			world.AddComponent<PreviewImage>(hSel, bgImage);
+void FadeInPreview(CWorld& world, const Appearance& appearance,
+				   const Query<With<PreviewFade, Audio::Player>>& fading,
+				   const CTimestep&                              ts) {
+	for (auto hSel : fading) {
+		auto& fade = fading.get<PreviewFade>(hSel);
+		fade.Elapsed += ts.GetMilliseconds();
+		const float t = std::min(fade.Elapsed / PreviewFade::Duration, 1.f);
+		fading.get<Audio::Player>(hSel).Volume = appearance.AudioVolume * t;
+		if (t >= 1.f) {
+			world.RemoveComponent<PreviewFade>(hSel);
 		}
 	}
 }
 
 void RemovePreview(
-	CWorld& world, const Query<With<MenuRoot, Audio::Player>>& bgPlayer,
-	const Query<With<Removed<Interaction>, SongSelect, Audio::Player>>&
-		selected) {
+	CWorld& world, const Query<With<Removed<Interaction>, SongSelect>>& selected) {
 	for (auto& hSel : selected) {
-		world.RemoveComponent<Audio::Player>(hSel);
-		if (world.Has<PreviewImage>(hSel)) {
-			world.RemoveComponent<PreviewImage>(hSel);
-		}
+		ClearPreview(world, hSel);
 	}
 }
 
+// Reacts to previews starting or stopping and to settings changes only. The
+// fade owns the volume of a preview until it completed.
 void EnsureBGMusic(
-	CWorld&                                            world,
-	const Appearance&                                  appearance,
-	const Query<With<MenuRoot, Style, Audio::Player>>& bgPlayer) {
-	for (auto hBg : bgPlayer) {
-		auto&          bg               = bgPlayer.get<Audio::Player>(hBg);
-		auto&          style            = bgPlayer.get<Style>(hBg);
+	CWorld&                                                             world,
+	const Appearance&                                                   appearance,
+	MenuSystemStats&                                                    stats,
+	const Query<With<MenuRoot, Style, AppliedAppearance>>&              menus,
+	const Query<With<Initialised<Audio::Player>, MenuRoot>>&            startedMusic,
+	const Query<With<SongSelect, Audio::Player>>&                       previews,
+	const Query<With<Initialised<Audio::Player>, SongSelect>>&          startedPreviews,
+	const Query<With<Removed<Audio::Player>, SongSelect>>&              stoppedPreviews,
+	const Query<With<Initialised<PreviewImage>, SongSelect>>&           shownImages,
+	const Query<With<Removed<PreviewImage>, SongSelect>>&               hiddenImages) {
+	auto isEmpty = [](const auto& query) { return query.begin() == query.end(); };
+	const bool isPreviewChanged = !isEmpty(startedPreviews) || !isEmpty(stoppedPreviews) ||
+								  !isEmpty(shownImages) || !isEmpty(hiddenImages) ||
+								  !isEmpty(startedMusic);
+
+	bool isUpdated = false;
+	for (auto hBg : menus) {
+		auto& applied = menus.get<AppliedAppearance>(hBg);
+		if (!isPreviewChanged && applied.BGDim == appearance.BGDim &&
+			applied.AudioVolume == appearance.AudioVolume)
+			continue;
+		applied   = AppliedAppearance{appearance.BGDim, appearance.AudioVolume};
+		isUpdated = true;
+
+		auto&          style            = menus.get<Style>(hBg);
 		bool           areSongsSelected = false;
 		Handle<CImage> previewImage{};
-		const auto selectedPlayers = world.Query<SongSelect, Audio::Player>();
-		for (auto hSelected : selectedPlayers) {
+		for (auto hSelected : previews) {
 			areSongsSelected = true;
-			selectedPlayers.get<Audio::Player>(hSelected).Volume =
-				appearance.AudioVolume;
+			if (!world.Has<PreviewFade>(hSelected)) {
+				previews.get<Audio::Player>(hSelected).Volume = appearance.AudioVolume;
+			}
 			if (world.Has<PreviewImage>(hSelected)) {
-				previewImage =
-					world.GetComponent<PreviewImage>(hSelected).Image;
+				previewImage = world.GetComponent<PreviewImage>(hSelected).Image;
 			}
 			break;
 		}
 
-		if (areSongsSelected) {
-			bg.Pause();
-		} else {
-			bg.Play();
-			bgPlayer.storage<Audio::Player>().patch(
-				hBg, [&appearance](Audio::Player& player) {
-					player.Volume = appearance.AudioVolume;
-				});
+		// Silent until AttachMenuMusic has the music
+		if (world.Has<Audio::Player>(hBg)) {
+			if (areSongsSelected) {
+				world.GetComponent<Audio::Player>(hBg).Pause();
+			} else {
+				world.GetComponent<Audio::Player>(hBg).Play();
+				world.GetRegistry().patch<Audio::Player>(
+					hBg, [&appearance](Audio::Player& player) {
+						player.Volume = appearance.AudioVolume;
+					});
+			}
 		}
 
 		if (previewImage) {
@@ -321,12 +905,16 @@ void EnsureBGMusic(
 			style.colour = SColourF::White(0.8f);
 		}
 	}
+	if (!isUpdated)
+		stats.Skip();
 }
 
-void SpawnSong(CWorld& world, App& app, SAssetManager& mgr,
+void SpawnSong(CWorld& world, const AsyncAssets& assets,
 			   const Query<With<Interaction, SongSelect>>&  selected,
-			   const Events<Event::System::SMouseBtnPress>& events,
-			   State<EGameState>&                           stateMachine) {
+			   const Query<With<PendingSong>>&              pending,
+			   const Events<Event::System::SMouseBtnPress>& events) {
+	if (pending.begin() != pending.end())
+		return;
 	for (const auto& e : events) {
 		if (e.ePressedBtn != EMouseBtn::Left &&
 			e.eKeyAction != EKeyAction::Press)
@@ -340,14 +928,53 @@ void SpawnSong(CWorld& world, App& app, SAssetManager& mgr,
 			continue;
 
 		RavenLogInfo("Playing: {}", song.Path);
-		world.AddComponent<CBeatmapController>(world.CreateEntity("Song"))
-			.Beatmap = mgr.Load(app, song.Path).OnSuccess().Typed<CBeatmap>();
+		world.AddComponent<PendingSong>(world.CreateEntity("Song"),
+										PendingSong{
+											.Beatmap = assets.Loader->Load<CBeatmap>(song.Path),
+										});
+		break;
+	}
+}
+
+void StartPendingSong(CWorld& world, const AsyncAssets& assets,
+					  const Assets<CBeatmap>&         beatmaps,
+					  const Query<With<PendingSong>>& pending,
+					  State<EGameState>&              stateMachine) {
+	for (auto hSong : pending) {
+		auto& song = pending.get<PendingSong>(hSong);
+		if (!song.Beatmap.IsReady())
+			continue;
+		// A failed load keeps the menu up, the loader already logged why
+		const auto* pBeatmap = beatmaps.Get(song.Beatmap.Get());
+		if (!pBeatmap) {
+			RavenLogWarning("Not starting the song, its beatmap failed to load");
+			world.RemoveEntity(hSong);
+			continue;
+		}
+		if (!song.Sound.IsValid()) {
+			song.Sound =
+				assets.Loader->Load<Audio::Sound>(std::string{pBeatmap->GetSongPath()});
+		}
+		if (!song.Sound.IsReady())
+			continue;
+		if (!song.Sound.Get()) {
+			RavenLogWarning("Not starting {}, its song failed to load",
+							pBeatmap->GetSongPath());
+			world.RemoveEntity(hSong);
+			continue;
+		}
+
+		// InitialiseHitObjects configures and starts the player
+		world.AddComponent<Audio::Player>(
+			hSong, Audio::Player{.Sound = song.Sound.Get(), .IsPlaying = false});
+		world.AddComponent<CBeatmapController>(hSong).Beatmap = song.Beatmap.Get();
+		world.RemoveComponent<PendingSong>(hSong);
 		stateMachine.Set(EGameState::Playing);
 		break;
 	}
 }
 
-void OpenMenu(CWorld& world, App& app, SAssetManager& mgr) {
+void OpenMenu(CWorld& world) {
 	auto hMenu = Widgets::UINode(world, "Menu Root",
 		Style {
 			.colour     = SColourF::White(0.8f),
@@ -358,12 +985,37 @@ void OpenMenu(CWorld& world, App& app, SAssetManager& mgr) {
 		});
 	world.AddComponent<MenuRoot>(hMenu);
 	world.AddComponent<Root>(hMenu);
+	world.AddComponent<AppliedAppearance>(hMenu);
+}
+
+// The music is attached once it is loaded, never by blocking the main thread
+void AttachMenuMusic(CWorld& world, MenuMusic& music, const AsyncAssets& assets,
+					 MenuSystemStats&                                     stats,
+					 const Query<With<MenuRoot>, WithOut<Audio::Player>>& silentMenus) {
+	if (silentMenus.begin() == silentMenus.end() || music.IsFailed) {
+		stats.Skip();
+		return;
+	}
+	if (!music.Sound) {
+		// Failed during startup, the load already reported why
+		if (!music.Pending.IsValid())
+			music.Pending = assets.Loader->Load<Audio::Sound>(std::string{MenuMusicPath});
+		if (!music.Pending.IsReady()) {
+			stats.Skip();
+			return;
+		}
+		music.Sound   = music.Pending.Get();
+		music.Pending = {};
+		if (!music.Sound) {
+			music.IsFailed = true;
+			RavenLogWarning("No menu music, the menu stays silent");
+			return;
+		}
+	}
 	world.AddComponent<Audio::Player>(
-		hMenu,
+		silentMenus.front(),
 		Audio::Player{
-			.Sound = mgr.Load(app, "project://Assets/Audio/BackgroundAudio.mp3")
-						 .OnSuccess()
-						 .Typed<Audio::Sound>(),
+			.Sound         = music.Sound,
 			.PlaybackSpeed = 1.f,
 			.Volume        = 0.4f,
 			.IsLooping     = true,
@@ -374,6 +1026,44 @@ void CloseMenu(CWorld& world, const Query<With<MenuRoot>>& menus) {
 	world.RemoveEntity(menus.front());
 }
 
+void ReportPreviewLatency(const PreviewLatency& latency) {
+	if (latency.Samples == 0)
+		return;
+	RavenLogInfo("Hover to preview over {} songs: mean {:.1f}ms, max {:.1f}ms, "
+				 "{} prefetched",
+				 latency.Samples, latency.TotalMs / latency.Samples,
+				 latency.MaxMs, latency.PrefetchHits);
+}
+
+// Only frames with an open menu are counted
+void BeginMenuFrame(MenuSystemStats& stats, const Query<With<MenuRoot>>& menus) {
+	const uint32 skipped = std::exchange(stats.Skipped, 0u);
+	if (menus.begin() == menus.end())
+		return;
+	++stats.Frames;
+	stats.TotalSkipped += skipped;
+	stats.MaxSkipped = std::max(stats.MaxSkipped, skipped);
+}
+
+// Startup ends with the first frame the menu is up, not when the splash closes
+void ReportTimeToInteractive(StartupTasks& startup, const Query<With<MenuRoot>>& menus) {
+	if (startup.IsInteractive || menus.begin() == menus.end())
+		return;
+	startup.IsInteractive = true;
+	const double start    = startup.Tasks->GetStartTime();
+	RavenLogInfo("Menu interactive after {:.0f}ms, loading took {:.0f}ms",
+				 GetMonotonicTimeMs() - start, startup.Tasks->GetLoadedTime() - start);
+}
+
+void ReportMenuSystemStats(MenuSystemStats& stats) {
+	if (stats.Frames == 0)
+		return;
+	RavenLogInfo("Menu systems skipped per frame over {} frames: mean {:.1f}, max {}",
+				 stats.Frames, static_cast<double>(stats.TotalSkipped) / stats.Frames,
+				 stats.MaxSkipped);
+	stats = MenuSystemStats{};
+}
+
 template <typename T> SystemDesc MenuPauseSystem(T&& sys) {
 	return SystemDesc{std::forward<T>(sys)}.WithCondition(
 		State<EGameState>::OnPause(EGameState::Menu));
@@ -385,20 +1075,28 @@ template <typename T> SystemDesc MenuResumeSystem(T&& sys) {
 }
 
 void BuildUIPlugin(Raven::App& app) {
-	auto& mgr = *app.GetResource<SAssetManager>();
 	app
 		.AddComponent<ScrollList>()
+		.AddComponent<VirtualList>()
+		.AddComponent<ListRow>()
+		.AddComponent<SearchText>()
 		.AddComponent<Slider>()
 		.AddComponent<MenuRoot>()
 		.AddComponent<SongSelect>()
-		.CreateResource<Appearance>(Appearance {
-			.Font = mgr.Load(app, "engine://Assets/Textures/Fonts/"
-								  "BalooBhaijaan2-Regular.ttf")
-						.OnSuccess()
-						.Typed<Font>(),
-		})
+		.CreateResource<Appearance>()
+		.CreateResource<MenuMusic>()
 		.CreateResource<UIState>()
+		.CreateResource<ThumbnailCache>(ThumbnailCache{
+			.Cache = std::make_shared<const CThumbnailCache>(
+				SAssetManager::ResolvePath(app, "project://Cache/Thumbnails").m_absolutePath),
+		})
+		.CreateResource<SongLibrary>()
+		.CreateResource<SongPrefetcher>()
+		.CreateResource<PreviewLatency>()
+		.CreateResource<MenuSystemStats>()
+		.AddSystem(DefaultStages::FIRST, &BeginMenuFrame)
 		.AddSystem(DefaultStages::PRE_UPDATE, &UpdateScrollList)
+		.AddSystem(DefaultStages::PRE_UPDATE, &IntegrateScrollLists)
 		.AddSystem(DefaultStages::PRE_UPDATE, &RemoveDrags)
 		.AddSystem(DefaultStages::PRE_UPDATE, &UpdateDrag)
 		.AddSystem(DefaultStages::PRE_UPDATE, &UpdateSliderValue)
@@ -406,15 +1104,60 @@ void BuildUIPlugin(Raven::App& app) {
 		.AddSystem(DefaultStages::PRE_UPDATE, &SpawnSettings)
 		.AddSystem(DefaultStages::PRE_UPDATE, &SpawnSongList)
 		.AddSystem(DefaultStages::PRE_UPDATE, &SpawnListItems)
+		.AddSystem(DefaultStages::PRE_UPDATE, &FinishSongRescan)
+		.AddSystem(DefaultStages::PRE_UPDATE, &UpdateSongSearch)
+		.AddSystem(DefaultStages::PRE_UPDATE, &BindSongRows)
 		.AddSystem(DefaultStages::PRE_UPDATE, &SpawnSong)
+		.AddSystem(DefaultStages::PRE_UPDATE, &StartPendingSong)
 		.AddSystem(DefaultStages::UPDATE, &AddPreview)
 		.AddSystem(DefaultStages::UPDATE, &RemovePreview)
+		.AddSystem(DefaultStages::UPDATE, &ResolvePreview)
+		.AddSystem(DefaultStages::UPDATE, &PrefetchNeighbours)
+		.AddSystem(DefaultStages::UPDATE, &FadeInPreview)
+		.AddSystem(DefaultStages::UPDATE, &AttachMenuMusic)
 		.AddSystem(DefaultStages::POST_UPDATE, &EnsureBGMusic)
+		.AddSystem(DefaultStages::LAST, &ReportTimeToInteractive)
 		.AddSystem(OSU::StateStage, MenuEnterSystem(&OpenMenu))
 		.AddSystem(OSU::StateStage, MenuResumeSystem(&OpenMenu))
 		.AddSystem(OSU::StateStage, MenuLeaveSystem(&CloseMenu))
+		.AddSystem(OSU::StateStage, MenuLeaveSystem(&ReportPreviewLatency))
+		.AddSystem(OSU::StateStage, MenuLeaveSystem(&ReportMenuSystemStats))
 		.AddSystem(OSU::StateStage, MenuPauseSystem(&CloseMenu))
 		;
+
+	auto& tasks = *app.GetResource<StartupTasks>()->Tasks;
+	auto  pFont = std::make_shared<Handle<Font>>();
+	tasks.Add(
+		"Font",
+		[&app, pFont] {
+			*pFont = LoadAsset(app, "engine://Assets/Textures/Fonts/BalooBhaijaan2-Regular.ttf")
+						 .OnSuccess()
+						 .Typed<Font>();
+		},
+		[&app, pFont] { app.GetResource<Appearance>()->Font = *pFont; });
+
+	auto pMusic = std::make_shared<Handle<Audio::Sound>>();
+	tasks.Add(
+		"Menu music",
+		[&app, pMusic] {
+			auto hRes = LoadAsset(app, std::string{MenuMusicPath});
+			if (hRes.IsSuccess()) {
+				*pMusic = hRes.OnSuccess().Typed<Audio::Sound>();
+			} else {
+				RavenLogWarning("Failed to load {}: {}", MenuMusicPath, hRes.OnFailed());
+			}
+		},
+		[&app, pMusic] { app.GetResource<MenuMusic>()->Sound = *pMusic; });
+
+	auto pIndex = std::make_shared<CSongIndex>();
+	tasks.Add(
+		"Song library",
+		[pIndex] { *pIndex = Detail::ScanSongs(); },
+		[&app, pIndex] {
+			auto& library = *app.GetResource<SongLibrary>();
+			library.Index = std::move(*pIndex);
+			library.Index.Search(library.Query, library.Sort, library.Visible);
+		});
 }
 }
 
@@ -422,7 +1165,9 @@ RAVEN_REFLECTION_BLOCK {
 	using namespace Raven;
 	using namespace OSU::UI;
 	Meta::TypeRegistry::Class_<MenuRoot>();
-	Meta::TypeRegistry::Class_<SongSelect>().Property(&SongSelect::Path, "Path");
+	Meta::TypeRegistry::Class_<SongSelect>()
+		.Property(&SongSelect::Path, "Path")
+		.Property(&SongSelect::Index, "Index");
 	Meta::TypeRegistry::Class_<ScrollList>();
 	Meta::TypeRegistry::Class_<Slider>()
 		.Property(&Slider::From, "From")
@@ -9,33 +9,42 @@ struct HUDRoot{};
 struct ComboText{};
 struct KeyVisual{EKey key;};
 struct AccuracyText{};
-
-void SpawnHUD(CWorld& world, const Appearance& appearance, App& app, SAssetManager& mgr, const Assets<CBeatmap>& beatmaps, const Query<With<CBeatmapController>>& gameControllers) {
+enum class EHUDValue : uint8 { Score, Accuracy, Combo };
+struct HUDNumber {
+	EHUDValue Value;
+};
+//! Background of the HUD root that is still loading
+struct PendingBackground {
+	TAssetFuture<CImage> Image;
+};
+
+void SpawnHUD(CWorld& world, const Appearance& appearance, const AsyncAssets& assets, const Skin& skin, const Assets<CBeatmap>& beatmaps, const Query<With<CBeatmapController>>& gameControllers) {
 	const CBeatmapController& controller = gameControllers.GetSingle();
 
 	auto* pBeatmap = beatmaps.Get(controller.Beatmap);
-	const auto hBGImage = LoadBackgroundImage(app, mgr, *pBeatmap);
-	// Root vbox
+	// Root vbox, black until the background arrives
 	auto hRoot = Widgets::UINode(world, "GameHUD", Style { 
-		.colour  = hBGImage ? SColourF::Grey(appearance.BGDim) : SColourF::Black(),
+		.colour  = SColourF::Black(),
 		.size    = Size::All(100_pc),
 		.eDirection = EFlexDirection::Column,
 		.eJustifyContent = EFlexJustifyContent::SpaceBetween,
 	});
 	UIBuilder root{hRoot, world};
 	root.WithComponent<Root, HUDRoot>();
+	const bool hasGlyphs = skin.HasScoreGlyphs();
 
-	if (hBGImage) {
-		world.AddComponent<Raven::UI::Image>(
-			hRoot, Raven::UI::Image{.hImg = hBGImage});
+	if (auto bgImage = LoadBackgroundImage(*assets.Loader, *pBeatmap); bgImage.IsValid()) {
+		world.AddComponent<PendingBackground>(hRoot, std::move(bgImage));
 	}
 
 	// Top hbox
-	root.Create("Top", Style{.colour     = SColourF::Red(0.f),
-							 .size       = Size::Height(10_pc),
-							 .eDirection = EFlexDirection::RowReverse})
-		.Text("Accuracy", appearance.Font, SColourF::White())
-		.WithComponent<AccuracyText>().Style().FlexBasis(10_pc);
+	auto top = root.Create("Top", Style{.colour     = SColourF::Red(0.f),
+										.size       = Size::Height(10_pc),
+										.eDirection = EFlexDirection::RowReverse});
+	if (!hasGlyphs) {
+		top.Text("Accuracy", appearance.Font, SColourF::White())
+			.WithComponent<AccuracyText>().Style().FlexBasis(10_pc);
+	}
 
 	// Center vbox
 	root.Create("Center",
@@ -66,35 +75,83 @@ void SpawnHUD(CWorld& world, const Appearance& appearance, App& app, SAssetManag
 
 
 	//Bottom hbox
-	root.Create("Bottom",
-				Style{
-					.colour = SColourF::Blue(0.f),
-					.size   = Size::Height(10_pc),
-				})
-		.Text("Combo", appearance.Font, SColourF::White())
-		.WithComponent<ComboText>();
+	auto bottom = root.Create("Bottom",
+							  Style{
+								  .colour = SColourF::Blue(0.f),
+								  .size   = Size::Height(10_pc),
+							  });
+	if (!hasGlyphs) {
+		bottom.Text("Combo", appearance.Font, SColourF::White())
+			.WithComponent<ComboText>();
+		return;
+	}
+
+	// Numbers drawn from the skin's score font in the corners of the playfield
+	auto spawnNumber = [&](const EHUDValue value, const GlyphNumber& number) {
+		auto hNumber = world.CreateEntity("HUDNumber");
+		world.AddComponent<HUDRoot>(hNumber);
+		world.AddComponent<HUDNumber>(hNumber, value);
+		world.AddComponent<GlyphNumber>(hNumber, number);
+	};
+	spawnNumber(EHUDValue::Score,
+				GlyphNumber{.Anchor = {632.f, 8.f}, .Height = 28.f, .IsRightAligned = true});
+	spawnNumber(EHUDValue::Accuracy,
+				GlyphNumber{.Anchor = {632.f, 40.f}, .Height = 16.f, .IsRightAligned = true});
+	spawnNumber(EHUDValue::Combo, GlyphNumber{.Anchor = {8.f, 444.f}, .Height = 28.f});
 }
 
-void UpdateCombo(const Query<With<GameScores>>&      scores,
-				 const Query<With<ComboText, Text>>& texts) {
-	const GameScores& score = scores.GetSingle();
-	for(auto hText : texts) {
-		auto& text = texts.get<Text>(hText);
-		text.text = std::to_string(score.Combo);
+void ApplyHUDBackground(CWorld& world, const Appearance& appearance,
+						const Query<With<PendingBackground, Style>>& roots) {
+	for (auto hRoot : roots) {
+		const auto& pending = roots.get<PendingBackground>(hRoot);
+		if (!pending.Image.IsReady())
+			continue;
+		if (const auto hImage = pending.Image.Get()) {
+			world.AddComponent<Raven::UI::Image>(hRoot,
+												 Raven::UI::Image{.hImg = hImage});
+			roots.get<Style>(hRoot).colour = SColourF::Grey(appearance.BGDim);
+		}
+		world.RemoveComponent<PendingBackground>(hRoot);
 	}
 }
 
-void UpdateAccuracy(const Query<With<GameScores>>&         scores,
-					const Query<With<AccuracyText, Text>>& texts) {
-	const GameScores& score = scores.GetSingle();
-	for (auto hText : texts) {
-		auto&      text = texts.get<Text>(hText);
+//! Only runs on frames where GameScores changed, see ScoresChanged
+void UpdateHUDScores(CWorld& world,
+					 const Query<With<GameScores, ScoresChanged>>& scores,
+					 const Query<With<HUDNumber, GlyphNumber>>&    numbers,
+					 const Query<With<ComboText, Text>>&           comboTexts,
+					 const Query<With<AccuracyText, Text>>&        accuracyTexts) {
+	for (auto hScores : scores) {
+		const GameScores& score = scores.get<GameScores>(hScores);
 		const auto potential =
 			(score.Hit300 + score.Hit100 + score.Hit50 + score.HitMiss) * 300;
-		text.text =
-			fmt::format("{}%/100%\n{}", (static_cast<float>(score.ScoreRaw) /
-								std::max(static_cast<float>(potential), 1.f)) *
-								   100.f, score.Score);
+		// Hundredths of a percent
+		const auto accuracy = static_cast<int32>(std::lround(
+			10000.0 * score.ScoreRaw / std::max(potential, 1)));
+
+		for (auto hNumber : numbers) {
+			auto& number = numbers.get<GlyphNumber>(hNumber);
+			switch (numbers.get<HUDNumber>(hNumber).Value) {
+			case EHUDValue::Score:
+				number.Set(score.Score);
+				break;
+			case EHUDValue::Accuracy:
+				number.Set(accuracy, 2, ScoreGlyphPercent);
+				break;
+			case EHUDValue::Combo:
+				number.Set(score.Combo, 0, ScoreGlyphX);
+				break;
+			}
+		}
+		// Text fallback for skins without a score font
+		for (auto hText : comboTexts) {
+			comboTexts.get<Text>(hText).text = std::to_string(score.Combo);
+		}
+		for (auto hText : accuracyTexts) {
+			accuracyTexts.get<Text>(hText).text = fmt::format(
+				"{:.2f}%\n{}", static_cast<float>(accuracy) / 100.f, score.Score);
+		}
+		world.RemoveComponent<ScoresChanged>(hScores);
 	}
 }
 
@@ -137,10 +194,12 @@ template <typename T> SystemDesc HUDLeaveSystem(T&& sys) {
 void BuildPlayerHUD(App& app) {
 	app
 		.AddComponent<HUDRoot>()
+		.AddComponent<HUDNumber>()
+		.AddComponent<GlyphNumber>()
 		.AddSystem(OSU::StateStage, HUDEnterSystem(&SpawnHUD))
 		.AddSystem(OSU::StateStage, HUDLeaveSystem(&RemoveHUD))
-		.AddSystem(DefaultStages::POST_UPDATE, &UpdateCombo)
-		.AddSystem(DefaultStages::POST_UPDATE, &UpdateAccuracy)
+		.AddSystem(DefaultStages::UPDATE, &ApplyHUDBackground)
+		.AddSystem(DefaultStages::POST_UPDATE, &UpdateHUDScores)
 		.AddSystem(DefaultStages::UPDATE, &HightlightKeys)
 		;
 }
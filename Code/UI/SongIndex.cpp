@@ -0,0 +1,249 @@
+#include "SongIndex.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <numeric>
+
+namespace OSU::UI {
+namespace {
+	std::string_view Trim(std::string_view str) {
+		constexpr std::string_view Whitespace = " \t\r\n";
+		const auto begin = str.find_first_not_of(Whitespace);
+		if (begin == std::string_view::npos)
+			return {};
+		return str.substr(begin, str.find_last_not_of(Whitespace) - begin + 1);
+	}
+
+	void ToLower(std::string& str) {
+		for (auto& c : str)
+			c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	}
+
+	bool LessNoCase(const std::string_view a, const std::string_view b) {
+		return std::lexicographical_compare(
+			std::begin(a), std::end(a), std::begin(b), std::end(b), [](char l, char r) {
+				return std::tolower(static_cast<unsigned char>(l)) <
+					   std::tolower(static_cast<unsigned char>(r));
+			});
+	}
+
+	uint32 Trigram(const std::string_view str, const size_t at) {
+		return static_cast<uint32>(static_cast<uint8>(str[at])) << 16 |
+			   static_cast<uint32>(static_cast<uint8>(str[at + 1])) << 8 |
+			   static_cast<uint32>(static_cast<uint8>(str[at + 2]));
+	}
+
+	template <typename T> T ParseOr(std::string_view str, const T fallback) {
+		T value = fallback;
+		std::from_chars(str.data(), str.data() + str.size(), value);
+		return value;
+	}
+
+	// Hit objects are sorted by time, the last line of the file has the length
+	int32 ReadLastObjectTime(std::ifstream& file) {
+		constexpr std::streamoff TailSize = 512;
+		file.clear();
+		file.seekg(0, std::ios::end);
+		const auto size = static_cast<std::streamoff>(file.tellg());
+		const auto tail = std::min(size, TailSize);
+		file.seekg(size - tail);
+		std::string buffer(static_cast<size_t>(tail), '\0');
+		file.read(buffer.data(), tail);
+
+		auto text = Trim(buffer);
+		const auto lineStart = text.find_last_of('\n');
+		if (lineStart != std::string_view::npos)
+			text = text.substr(lineStart + 1);
+		// x,y,time,...
+		const auto first  = text.find(',');
+		const auto second = first == std::string_view::npos ? first : text.find(',', first + 1);
+		if (second == std::string_view::npos)
+			return 0;
+		const auto third = text.find(',', second + 1);
+		return ParseOr(text.substr(second + 1, third - second - 1), 0);
+	}
+} // namespace
+
+SongEntry SongEntry::Read(const std::filesystem::path& path) {
+	SongEntry entry{};
+	entry.Path  = path.string();
+	entry.Title = path.filename().stem().string();
+	std::ifstream file{path, std::ios::binary};
+	if (!file) {
+		RavenLogWarning("Failed to open {}", entry.Path);
+		return entry;
+	}
+
+	std::string      line;
+	std::string_view section;
+	while (std::getline(file, line)) {
+		const auto trimmed = Trim(line);
+		if (trimmed.starts_with('[')) {
+			section = trimmed == "[Metadata]"       ? "Metadata"
+					: trimmed == "[Difficulty]"     ? "Difficulty"
+					: trimmed == "[TimingPoints]"   ? "TimingPoints"
+					: trimmed == "[HitObjects]"     ? "HitObjects"
+													: "";
+			if (section == "HitObjects")
+				break;
+			continue;
+		}
+
+		if (section == "TimingPoints") {
+			// time,beatLength,... where a positive beat length is uninherited
+			const auto comma = trimmed.find(',');
+			if (entry.Bpm == 0.f && comma != std::string_view::npos) {
+				const auto beatLength = ParseOr(
+					trimmed.substr(comma + 1, trimmed.find(',', comma + 1) - comma - 1), 0.f);
+				if (beatLength > 0.f)
+					entry.Bpm = 60000.f / beatLength;
+			}
+			continue;
+		}
+
+		const auto colon = trimmed.find(':');
+		if (colon == std::string_view::npos)
+			continue;
+		const auto key   = Trim(trimmed.substr(0, colon));
+		const auto value = Trim(trimmed.substr(colon + 1));
+		if (section == "Metadata") {
+			if (key == "Title")
+				entry.Title = value;
+			else if (key == "Artist")
+				entry.Artist = value;
+			else if (key == "Creator")
+				entry.Creator = value;
+			else if (key == "Version")
+				entry.Version = value;
+			else if (key == "Tags")
+				entry.Tags = value;
+		} else if (section == "Difficulty" && key == "OverallDifficulty") {
+			entry.OverallDifficulty = ParseOr(value, 0.f);
+		}
+	}
+
+	entry.Length = ReadLastObjectTime(file);
+	std::error_code err;
+	entry.DateAdded = std::chrono::duration_cast<std::chrono::seconds>(
+						  std::filesystem::last_write_time(path, err).time_since_epoch())
+						  .count();
+	return entry;
+}
+
+std::string_view ToString(const ESongSort sort) {
+	constexpr std::array Names = {"Title", "Artist", "BPM", "Length", "Difficulty", "Date added"};
+	static_assert(Names.size() == static_cast<size_t>(ESongSort::Count));
+	return Names[static_cast<size_t>(sort)];
+}
+
+void CSongIndex::Build(std::vector<SongEntry> entries) {
+	m_entries = std::move(entries);
+	m_text.clear();
+	m_trigrams.clear();
+	m_marks.assign(m_entries.size(), 0);
+	m_generation = 0;
+
+	const auto count = static_cast<uint32>(m_entries.size());
+	std::vector<uint32> entryTrigrams;
+	for (uint32 i = 0; i < count; ++i) {
+		const auto& entry = m_entries[i];
+		// Fields are separated by a character queries never contain, so no word
+		// matches across the end of one field and the start of the next
+		auto& text = m_text.emplace_back(fmt::format("{}\n{}\n{}\n{}\n{}", entry.Title,
+													 entry.Artist, entry.Creator,
+													 entry.Version, entry.Tags));
+		ToLower(text);
+
+		entryTrigrams.clear();
+		for (size_t c = 0; c + 3 <= text.size(); ++c) {
+			entryTrigrams.emplace_back(Trigram(text, c));
+		}
+		std::sort(std::begin(entryTrigrams), std::end(entryTrigrams));
+		entryTrigrams.erase(std::unique(std::begin(entryTrigrams), std::end(entryTrigrams)),
+							std::end(entryTrigrams));
+		for (const auto trigram : entryTrigrams) {
+			m_trigrams[trigram].emplace_back(i);
+		}
+	}
+
+	auto sortBy = [&](const ESongSort sort, auto less) {
+		auto& order = m_order[static_cast<size_t>(sort)];
+		order.resize(count);
+		std::iota(std::begin(order), std::end(order), 0u);
+		std::stable_sort(std::begin(order), std::end(order), [&](uint32 a, uint32 b) {
+			return less(m_entries[a], m_entries[b]);
+		});
+	};
+	sortBy(ESongSort::Title, [](const SongEntry& a, const SongEntry& b) {
+		return LessNoCase(a.Title, b.Title);
+	});
+	sortBy(ESongSort::Artist, [](const SongEntry& a, const SongEntry& b) {
+		return LessNoCase(a.Artist, b.Artist);
+	});
+	sortBy(ESongSort::Bpm, [](const SongEntry& a, const SongEntry& b) { return a.Bpm < b.Bpm; });
+	sortBy(ESongSort::Length, [](const SongEntry& a, const SongEntry& b) {
+		return a.Length < b.Length;
+	});
+	sortBy(ESongSort::Difficulty, [](const SongEntry& a, const SongEntry& b) {
+		return a.OverallDifficulty < b.OverallDifficulty;
+	});
+	sortBy(ESongSort::DateAdded, [](const SongEntry& a, const SongEntry& b) {
+		return a.DateAdded > b.DateAdded;
+	});
+}
+
+void CSongIndex::Search(const std::string_view query, const ESongSort sort,
+						std::vector<uint32>& dst) const {
+	const auto& order = m_order[static_cast<size_t>(sort)];
+	dst.clear();
+
+	std::string lowered{query};
+	ToLower(lowered);
+	std::vector<std::string_view> words;
+	for (size_t begin = lowered.find_first_not_of(' '); begin != std::string::npos;) {
+		const auto end = lowered.find(' ', begin);
+		words.emplace_back(std::string_view{lowered}.substr(begin, end - begin));
+		begin = lowered.find_first_not_of(' ', end);
+	}
+	if (words.empty()) {
+		dst = order;
+		return;
+	}
+
+	// Candidates come from the rarest trigram of the query, short queries
+	// without any trigram fall back to scanning every entry
+	const std::vector<uint32>* pCandidates = nullptr;
+	for (const auto word : words) {
+		for (size_t c = 0; c + 3 <= word.size(); ++c) {
+			const auto it = m_trigrams.find(Trigram(word, c));
+			if (it == std::end(m_trigrams))
+				return;
+			if (!pCandidates || it->second.size() < pCandidates->size())
+				pCandidates = &it->second;
+		}
+	}
+
+	// Trigrams only narrow the search down, the words are still verified
+	++m_generation;
+	auto verify = [&](const uint32 idx) {
+		const std::string_view text = m_text[idx];
+		for (const auto word : words) {
+			if (text.find(word) == std::string_view::npos)
+				return;
+		}
+		m_marks[idx] = m_generation;
+	};
+	if (pCandidates) {
+		std::for_each(std::begin(*pCandidates), std::end(*pCandidates), verify);
+	} else {
+		for (uint32 i = 0; i < GetSize(); ++i)
+			verify(i);
+	}
+
+	for (const auto idx : order) {
+		if (m_marks[idx] == m_generation)
+			dst.emplace_back(idx);
+	}
+}
+} // namespace OSU::UI
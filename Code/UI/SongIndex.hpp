@@ -0,0 +1,58 @@
+#pragma once
+#include <RavenApp/RavenApp.hpp>
+
+#include <filesystem>
+
+namespace OSU::UI {
+//! Header data of a single .osu file, read without loading the beatmap
+struct SongEntry {
+	std::string Path;
+	std::string Title;
+	std::string Artist;
+	std::string Creator;
+	std::string Version; // Difficulty name
+	std::string Tags;
+	float       Bpm               = 0.f; // Of the first uninherited timing point
+	int32       Length            = 0;   // ms, time of the last hit object
+	float       OverallDifficulty = 0.f;
+	int64       DateAdded         = 0; // Last write time, only used for ordering
+
+	static SongEntry Read(const std::filesystem::path& path);
+};
+
+enum class ESongSort : uint8 {
+	Title = 0,
+	Artist,
+	Bpm,
+	Length,
+	Difficulty, // OverallDifficulty, there is no star rating calculator
+	DateAdded,  // Newest first
+
+	Count,
+};
+std::string_view ToString(ESongSort sort);
+
+//! In-memory search over the song library. Title, artist, creator, version and
+//! tags are indexed by trigram, every sort order is precomputed on Build.
+class CSongIndex {
+  public:
+	void Build(std::vector<SongEntry> entries);
+
+	//! Entries containing every whitespace separated word of `query`
+	//! (case-insensitive), in `sort` order. All entries for an empty query.
+	void Search(std::string_view query, ESongSort sort, std::vector<uint32>& dst) const;
+
+	const SongEntry& Get(const uint32 idx) const { return m_entries[idx]; }
+	uint32 GetSize() const { return static_cast<uint32>(m_entries.size()); }
+
+  private:
+	std::vector<SongEntry>   m_entries;
+	std::vector<std::string> m_text; // Lower case searchable text per entry
+	std::unordered_map<uint32, std::vector<uint32>> m_trigrams; // Ascending entries
+	std::array<std::vector<uint32>, static_cast<size_t>(ESongSort::Count)> m_order;
+
+	// Scratch of Search, an entry matched if its mark equals the generation
+	mutable std::vector<uint32> m_marks;
+	mutable uint32              m_generation = 0;
+};
+} // namespace OSU::UI
@@ -1,8 +1,10 @@
 #include "UICommon.hpp"
+#include "StartupTasks.hpp"
 #include <Timer.h>
 #include <DefaultComponents.hpp>
 #include <RenderSystem.hpp>
 #include <RavenWindow/Window.hpp>
+#include <Events/SystemEvents.hpp>
 
 namespace OSU::UI {
 using namespace Raven;
@@ -11,6 +13,21 @@ using namespace Raven::UI;
 struct SplashTimer {
 	CTimer Timer{false};
 	int32 CurrentItem = -1;
+	// Set once the current item ends the splash, it fades out and shrinks
+	// from its brightness at EndTime
+	float EndTime       = -1.f; // s on Timer
+	float EndDuration   = 0.f;
+	float EndBrightness = 1.f;
+
+	bool  IsEnding() const { return EndTime >= 0.f; }
+	float GetTime() { return static_cast<float>(Timer.GetEllapsedTime()); }
+	//! 1 until the splash ends, 0 once it faded out
+	float GetEndFactor(const float t) const {
+		if (!IsEnding())
+			return 1.f;
+		return EndDuration > 0.f ? std::clamp(1.f - (t - EndTime) / EndDuration, 0.f, 1.f)
+								 : 0.f;
+	}
 };
 
 struct SplashItem {
@@ -21,11 +38,29 @@ struct SplashItem {
 };
 
 struct SplashSequence {
+	static constexpr double MinDuration     = 4.0;  // s, shown even if loading is done
+	static constexpr float  SkipFadeOut     = 0.3f; // s
+
+	bool                    IsSkipRequested = false;
+
 	std::vector<SplashItem> ItemSequence{};
+	std::vector<TAssetFuture<CImage>> Images{}; // Requested up front, per item
 	Window::Id              WindowId{};
 	Handle<CWorld>          World{};
+	double                  StartTime = 0.0; // Monotonic ms
+	double                  ShownTime = 0.0; // Monotonic ms, first image on screen
 };
 
+float GetBrightness(const SplashItem& item, const SplashTimer& timer, const float t) {
+	if (timer.IsEnding())
+		return timer.EndBrightness * timer.GetEndFactor(t);
+	if (t <= item.FadeInDuration)
+		return t / item.FadeInDuration;
+	if (t <= item.FadeInDuration + item.Duration)
+		return 1.f;
+	return std::max(1.f - (t - item.FadeInDuration - item.Duration) / item.FadeOutDuration, 0.f);
+}
+
 template <typename T> Raven::SystemDesc EnterSplashSystem(T&& sys) {
 	return Raven::SystemDesc{std::forward<T>(sys)}.WithCondition(
 		Raven::State<EGameState>::OnEnter(EGameState::SplashScreen));
@@ -55,10 +90,19 @@ std::vector<SplashItem> CreateSplashSequence() {
 	}};
 }
 
-void CreateSplashWindow(App& app, Assets<CWorld>& worlds,
+void CreateSplashWindow(App& app, Assets<CWorld>& worlds, const AsyncAssets& assets,
+						const StartupTasks&       startup,
 						Window::Windows&          windows,
 						const Window::MainWindow& mainWindow,
 						const Window::Monitors&   monitors) {
+		// Requested before the startup tasks start so no task load runs ahead
+		// of them, the splash is on screen while the rest loads
+		auto items = CreateSplashSequence();
+		std::vector<TAssetFuture<CImage>> images;
+		for (const auto& item : items) {
+			images.emplace_back(assets.Loader->Load<CImage>(item.ImagePath, ELoadPriority::High));
+		}
+		startup.Tasks->Start();
 		auto hGameWorld = worlds.Create();
 
 		auto* pWorld = worlds.GetMut(hGameWorld);
@@ -69,9 +113,10 @@ void CreateSplashWindow(App& app, Assets<CWorld>& worlds,
 		cam.isActive = true;
 		pWorld->AddComponent<STransformComponent>(hCam).m_translation.y = 10.f;
 		pWorld->AddOrReplace<SRenderInfo>(hCam);
+		// Takes input so the sequence can be skipped
 		auto hWnd = windows.Create(
 			"Splash window", int2{512, 512}, Window::EPresentMode::NoVSync,
-			Window::EInitConfig::NoDecorations | Window::EInitConfig::NoInputs);
+			Window::EInitConfig::NoDecorations);
 
 		//const auto hWnd = mainWindow.m_hId; 
 
@@ -85,9 +130,11 @@ void CreateSplashWindow(App& app, Assets<CWorld>& worlds,
 		pWorld->AddComponent<Raven::RenderTargetT>(hCam, hWnd);
 
 		app.CreateResource<SplashSequence>(SplashSequence{
-			.ItemSequence = CreateSplashSequence(),
+			.ItemSequence = std::move(items),
+			.Images       = std::move(images),
 			.WindowId     = hWnd,
 			.World        = hGameWorld,
+			.StartTime    = GetMonotonicTimeMs(),
 		});
 
 		UIBuilder{Widgets::UINode(*pWorld, "SplashRoot",
@@ -96,79 +143,106 @@ void CreateSplashWindow(App& app, Assets<CWorld>& worlds,
 			.WithComponent<Root, Image, SplashTimer>();
 }
 
-void UpdateSplash(App& app, SAssetManager& mgr, const SplashSequence& seq,
+// Any key or mouse button ends the splash as soon as loading finished
+void SkipSplash(SplashSequence&                              seq,
+				const Events<Event::System::SKeyPress>&      keys,
+				const Events<Event::System::SMouseBtnPress>& buttons) {
+	for (const auto& e : keys) {
+		seq.IsSkipRequested = seq.IsSkipRequested || e.eKeyAction == EKeyAction::Press;
+	}
+	for (const auto& e : buttons) {
+		seq.IsSkipRequested = seq.IsSkipRequested || e.eKeyAction == EKeyAction::Press;
+	}
+}
+
+// The sequence starts once every image was decoded. It is cut short once
+// loading finished and either the minimum duration passed or it was skipped,
+// the current item then fades out from its current brightness.
+void UpdateSplash(SplashSequence& seq, const StartupTasks& startup,
 				  const Query<With<SplashTimer, Image>>& timers, State<EGameState>& stateMachine) {
+	const bool isLoaded = startup.Tasks->Poll();
+	const bool canEnd =
+		isLoaded && (seq.IsSkipRequested ||
+					 GetMonotonicTimeMs() - seq.StartTime >= SplashSequence::MinDuration * 1000.0);
+
 	auto enqueue = [&](SplashTimer& timer, Image& image, int32 imageIdx) {
 		timer.Timer.Start();
 		timer.CurrentItem = imageIdx;
-		image.hImg = mgr.Load(app, seq.ItemSequence[timer.CurrentItem].ImagePath)
-						 .OnSuccess()
-						 .Typed<CImage>();
+		image.hImg        = seq.Images[imageIdx].Get();
+	};
+	auto beginEnding = [](SplashTimer& timer, const SplashItem& item, const float t,
+				  const float fadeOut) {
+		timer.EndBrightness = GetBrightness(item, timer, t);
+		timer.EndDuration   = fadeOut * timer.EndBrightness;
+		timer.EndTime       = t;
 	};
 	timers.each([&](SplashTimer& timer, Image& image) {
-		int32 toEnqueue = -1;
 		if(timer.CurrentItem == -1) {
-			toEnqueue = 0;
-		}
-		const auto& currentItem = seq.ItemSequence[timer.CurrentItem];
-		if(timer.Timer.GetEllapsedTime() >= currentItem.Duration + currentItem.FadeInDuration + currentItem.FadeOutDuration) {
-			const auto next = timer.CurrentItem + 1;
-			if(next >= seq.ItemSequence.size()) {
-
+			if (canEnd) {
 				stateMachine.Set(EGameState::Menu);
-			} else {
-				toEnqueue = next;
+			} else if (std::ranges::all_of(seq.Images, [](const auto& hImage) {
+						   return hImage.IsReady();
+					   })) {
+				enqueue(timer, image, 0);
+				seq.ShownTime = GetMonotonicTimeMs();
+				RavenLogInfo("Splash shown after {:.1f}ms",
+							 seq.ShownTime - startup.Tasks->GetStartTime());
 			}
-
+			return;
 		}
-		if(toEnqueue >= 0) {
-			enqueue(timer, image, toEnqueue);
+		const auto& currentItem  = seq.ItemSequence[timer.CurrentItem];
+		const float fadeOutStart = currentItem.FadeInDuration + currentItem.Duration;
+		const float t            = timer.GetTime();
+		const bool  isLastItem =
+			static_cast<size_t>(timer.CurrentItem) + 1 >= seq.ItemSequence.size();
+		if (!timer.IsEnding()) {
+			if (canEnd) {
+				beginEnding(timer, currentItem, t,
+					seq.IsSkipRequested ? SplashSequence::SkipFadeOut
+										: currentItem.FadeOutDuration);
+			} else if (isLastItem && t >= fadeOutStart) {
+				beginEnding(timer, currentItem, t, currentItem.FadeOutDuration);
+			}
 		}
 
+		if (timer.IsEnding()) {
+			// Stays dark until loading finished
+			if (timer.GetEndFactor(t) <= 0.f && isLoaded)
+				stateMachine.Set(EGameState::Menu);
+		} else if (t >= fadeOutStart + currentItem.FadeOutDuration) {
+			enqueue(timer, image, timer.CurrentItem + 1);
+		}
 	});
 }
 
+// Fades and shrinks the image inside the fixed size window, the window itself
+// is never resized
 void UpdateFade(const Query<With<SplashTimer, Style>>& timers,
 				const SplashSequence&                  seq) {
 	timers.each([&](SplashTimer& timer, Style& style) {
-		auto t = static_cast<float>(timer.Timer.GetEllapsedTime());
-		const auto& item = seq.ItemSequence[timer.CurrentItem];
-		if(t <= item.FadeInDuration) {
-			t = t / item.FadeInDuration;
-		} else if(t <= item.FadeInDuration + item.Duration) {
-			t = (t - item.FadeInDuration) / item.Duration;
-			t = 1.f;
-		} else {
-			t = 1.f - (t - item.FadeInDuration - item.Duration) / item.FadeOutDuration;
+		if (timer.CurrentItem < 0) {
+			style.colour = SColourF::Grey(0.f, 1.f);
+			return;
+		}
+		const float t = timer.GetTime();
+		style.colour  = SColourF::Grey(
+			GetBrightness(seq.ItemSequence[timer.CurrentItem], timer, t), 1.f);
+		if (timer.IsEnding()) {
+			const float scale = timer.GetEndFactor(t);
+			style.size        = Size::All(Dimension::Pc(scale));
+			style.margin      = Rect::All(Dimension::Pc((1.f - scale) * 0.5f));
 		}
-		style.colour = SColourF::Grey(t, 1.f);
 	});
 }
 
-void ScaleWindow(const Query<With<SplashTimer>>& timers,
-				 const SplashSequence& seq, Window::Windows& windows, const Window::Monitors& monitors) {
-	timers.each([&](SplashTimer& timer) {
-
-		auto t = static_cast<float>(timer.Timer.GetEllapsedTime());
-		const auto& item = seq.ItemSequence[timer.CurrentItem];
-		if(t <= item.FadeInDuration) {
-		} else if(t <= item.FadeInDuration + item.Duration) {
-		} else {
-			t = 1.f - (t - item.FadeInDuration - item.Duration) / item.FadeOutDuration;
-			if(timer.CurrentItem == seq.ItemSequence.size() - 1) {
-				auto* pWindow = windows.Get(seq.WindowId);
-				pWindow->SetRequestedDimensions(
-					int2(glm::floor(float2{512, 512} * t)));
-				pWindow->Position(
-					glm::floor(float2(monitors.m_monitors[0].m_workAreaSize -
-									  pWindow->RequestedDimensions()) /
-							   2.f));
-			}
-		}
-		});
-}
+void ReleaseSplashSequence(App& app, Assets<CWorld>& worlds, SplashSequence& seq, Window::Windows& windows, const Window::MainWindow& mainWindow, const StartupTasks& startup) {
+	// How much of the startup loading the splash hid
+	const double start   = startup.Tasks->GetStartTime();
+	const double loaded  = startup.Tasks->GetLoadedTime();
+	const double overlap = seq.ShownTime > 0.0 ? std::max(loaded - seq.ShownTime, 0.0) : 0.0;
+	RavenLogInfo("Startup loading took {:.1f}ms, {:.1f}ms of it behind the splash",
+				 loaded - start, overlap);
 
-void ReleaseSplashSequence(App& app, Assets<CWorld>& worlds, SplashSequence& seq, Window::Windows& windows, const Window::MainWindow& mainWindow) {
 	if(seq.WindowId != mainWindow.m_hId) {
 		windows.Release(seq.WindowId);
 		windows.Get(mainWindow)->SetIsMinimised(false);
@@ -186,9 +260,9 @@ void BuildSplashScreen(App& app) {
 		.AddSystem(StateStage, EnterSplashSystem(&CreateSplashWindow))
 		.AddSystem(StateStage, LeaveSplashSystem(&ReleaseSplashSequence)
 								   .Flags(ESystemFlags::ForceSingleThreaded))
+		.AddSystem(StateStage, SplashSystem(&SkipSplash))
 		.AddSystem(StateStage, SplashSystem(&UpdateSplash))
 		.AddSystem(StateStage, SplashSystem(&UpdateFade))
-		.AddSystem(StateStage, SplashSystem(&ScaleWindow))
 		.AddComponent<SplashTimer>()
 		;
 	app.GetResource<State<EGameState>>()->Set(EGameState::SplashScreen);
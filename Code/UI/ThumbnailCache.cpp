@@ -0,0 +1,38 @@
+#include "ThumbnailCache.hpp"
+#include "ImageCodec.hpp"
+
+namespace OSU::UI {
+CThumbnailCache::CThumbnailCache(std::filesystem::path directory)
+	: m_directory(std::move(directory)), m_manifest(m_directory / "manifest.txt") {
+	std::error_code err;
+	std::filesystem::create_directories(m_directory, err);
+	if (err) {
+		RavenLogWarning("Failed to create thumbnail cache {}: {}", m_directory.string(),
+						err.message());
+	}
+}
+
+std::optional<std::string>
+CThumbnailCache::GetOrCreate(const std::filesystem::path& source) const {
+	// Cached thumbnails of unchanged sources are found without reading them
+	const auto hash = m_manifest.GetHash(source);
+	if (!hash)
+		return std::nullopt;
+	const auto path = m_directory / fmt::format("{:016x}.png", *hash);
+	if (std::filesystem::exists(path))
+		return path.string();
+
+	const auto bytes = ImageCodec::ReadFile(source);
+	if (!bytes)
+		return std::nullopt;
+	const auto image = ImageCodec::Decode(*bytes, source.string());
+	if (!image)
+		return std::nullopt;
+	const auto width     = std::min(image->Width, MaxWidth);
+	const auto height    = std::max(image->Height * width / image->Width, 1u);
+	const auto thumbnail = ImageCodec::Downscale(*image, width, height);
+	if (!ImageCodec::Write(path, thumbnail, EImageFormat::Png))
+		return std::nullopt;
+	return path.string();
+}
+} // namespace OSU::UI
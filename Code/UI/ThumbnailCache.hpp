@@ -0,0 +1,28 @@
+#pragma once
+#include "HashManifest.hpp"
+
+#include <filesystem>
+
+namespace OSU::UI {
+//! Downscaled copies of beatmap backgrounds kept on disk, keyed by a hash of
+//! the source file, see CHashManifest. The menu only ever decodes these small
+//! images.
+class CThumbnailCache {
+  public:
+	static constexpr uint32 MaxWidth = 480; // px, enough for a dimmed backdrop
+
+	explicit CThumbnailCache(std::filesystem::path directory);
+
+	//! Path of the thumbnail of `source`, created on first use.
+	//! Blocks on file I/O and decoding, only call it from a worker thread.
+	std::optional<std::string> GetOrCreate(const std::filesystem::path& source) const;
+
+  private:
+	std::filesystem::path m_directory;
+	mutable CHashManifest m_manifest; // Thread-safe, saved on destruction
+};
+
+struct ThumbnailCache {
+	std::shared_ptr<const CThumbnailCache> Cache;
+};
+} // namespace OSU::UI
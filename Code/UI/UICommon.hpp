@@ -3,6 +3,9 @@
 #include <RavenApp/RavenApp.hpp>
 #include <RavenUI/RavenUI.hpp>
 #include "RavenOSU.hpp"
+#include "AsyncAssets.hpp"
+
+#include <optional>
 
 namespace OSU::UI {
 //! General style variables of the game
@@ -12,8 +15,32 @@ struct Appearance {
 	float AudioVolume = 1.f;
 };
 
+//! Scrolling translates the children, the list's style never changes. Layout
+//! only writes SComputedLayout, the children's transforms are left alone.
 struct ScrollList {
+	static constexpr float Impulse  = 1500.f; // px/s added per wheel step
+	static constexpr float Friction = 8.f;    // 1/s, exponential velocity decay
+
 	float ScrollOffset = 0.f;
+	float Velocity     = 0.f; // px/s
+	std::optional<float> AppliedTranslation; // Last written to the children, empty forces a write
+};
+//! ScrollList that keeps a fixed pool of PoolSize row entities instead of one
+//! per item. The rows are rebound from a backing array whenever the scroll
+//! offset crosses a row boundary, see ListRow.
+struct VirtualList {
+	static constexpr uint32 PoolSize = 24; // Viewport plus a margin of rows
+	static constexpr uint32 Margin   = 2;  // Rows kept above the viewport
+
+	float  RowHeight = 100.f; // px, has to match the row style
+	uint32 ItemCount = 0;
+	uint32 FirstItem = 0;     // Item bound to the row in slot 0
+	uint32 TopItem   = 0;     // First item intersecting the viewport
+	bool   IsDirty   = true;
+};
+//! Pooled row of a VirtualList
+struct ListRow {
+	uint32 Slot = 0;
 };
 struct Slider {
 	float Value = 0.f;
@@ -21,6 +48,8 @@ struct Slider {
 	float To   = 1.f;
 	std::function<void(float)> OnChange;
 };
+//! Slider whose handle is moved to its value once its track is laid out
+struct DirtySlider {};
 struct DragInteraction {
 	float2 From{};
 	float2 PrevPos{};
@@ -169,11 +198,12 @@ struct UIBuilder {
 						.maxSize     = Size::Width(10_pc),
 						.aspectRatio = 0.5_pc,
 					})
-			.WithComponent(std::tuple<Slider, Raven::UI::Button>{
+			.WithComponent(std::tuple<Slider, DirtySlider, Raven::UI::Button>{
 				Slider{.Value    = defVal,
 					   .From     = min,
 					   .To       = max,
 					   .OnChange = std::move(fn)},
+				{},
 				{}});
 	}
 
@@ -204,17 +234,11 @@ struct UIBuilder {
 };
 
 
-static Raven::Handle<Raven::CImage>
-LoadBackgroundImage(Raven::App& app, Raven::SAssetManager& mgr,
-					const CBeatmap& beatmap) {
-	if (!beatmap.GetBackground().empty()) {
-		auto bg = mgr.Load(app, beatmap.GetBackground());
-		if (bg.IsSuccess()) {
-			return bg.OnSuccess().Typed<Raven::CImage>();
-		} else {
-			RavenLogWarning("Failed to load bg: {}", bg.OnFailed());
-		}
-	}
-	return Raven::Handle<Raven::CImage>{};
+//! Invalid future if the beatmap has no background
+static TAssetFuture<Raven::CImage> LoadBackgroundImage(CAsyncAssets&   assets,
+													   const CBeatmap& beatmap) {
+	if (beatmap.GetBackground().empty())
+		return {};
+	return assets.Load<Raven::CImage>(std::string{beatmap.GetBackground()});
 }
 } // namespace OSU::UI
\ No newline at end of file
@@ -8,10 +8,19 @@
 #include "IInput.h"
 
 #include "RavenOSU.hpp"
+#include "GameClock.hpp"
+#include "Input.hpp"
+#include "Simulation.hpp"
+#include "Hitsounds.hpp"
+#include "AsyncAssets.hpp"
+#include "StartupTasks.hpp"
+#include "SkinCache.hpp"
 #include <RavenWorld/DefaultComponents.hpp>
 #include <RavenRenderer/RenderOutput.hpp>
 #include <CVar.hpp>
 
+#include <charconv>
+
 namespace OSU {
 using namespace Raven;
 namespace Detail {
@@ -44,13 +53,6 @@ namespace Detail {
 
 } // namespace Detail
 
-struct ScoreDriver {
-	int Score = 0;
-	float TimeSinceSpawn = 0;
-	float TotalTime      = 0;
-	TEntity EffectEntity{};
-};
-
 float4 GetScoreSpriteCol(const int score) {
 	return score == 300 ? float4{0.f, 1.f, 0.f, 1.f}
 		 : score == 100 ? float4{0.f, 0.f, 1.f, 1.f}
@@ -58,21 +60,14 @@ float4 GetScoreSpriteCol(const int score) {
 						: float4{0.f, 0.f, 0.f, 1.f};
 }
 
-Handle<CImage> GetScoreSpriteTexture(const int score, const Skin& skin) {
-	return score == 300 ? skin.Images.find("hit300")->second
-		 : score == 100 ? skin.Images.find("hit100")->second
-		 : score == 50  ? skin.Images.find("hit50")->second
-						: skin.Images.find("hit0")->second;
-}
-
-void CreateScoreDriver(CWorld& world, const Skin& skin, const Raven::TEntity& dst, const int score, float2 pos, float extraDuration) {
-	constexpr int64 ScoreLifetime = 500;
-	auto hScoreHitEnt = world.CreateEntity("HitEffect");
-	world.AddComponent<ScoreDriver>(dst, score, 0.f, ScoreLifetime + extraDuration, hScoreHitEnt);
-
-	world.AddComponent<STransformComponent>(hScoreHitEnt).m_translation = float3{pos, 10.f};
-	world.AddComponent<Sprite::SSprite>(hScoreHitEnt).hImg =
-		GetScoreSpriteTexture(score, skin);
+void Judge(CWorld& world, JudgementEffects& effects, const Raven::TEntity& dst,
+		   const int score, float2 pos, float extraDuration) {
+	world.AddComponent<Judged>(dst, score);
+	effects.Push(JudgementEffect{
+		.Position  = pos,
+		.Score     = score,
+		.TotalTime = JudgementEffect::Lifetime + extraDuration,
+	});
 }
 
 class CBeatmapLoader : public Raven::IAssetLoader {
@@ -96,6 +91,7 @@ class CBeatmapLoader : public Raven::IAssetLoader {
 				IsBitSet(type, HitObject::Circle)   ? HitObject::Circle
 				: IsBitSet(type, HitObject::Slider) ? HitObject::Slider
 													: HitObject::Spinner;
+			hitObject.HitSound     = substrings.size() > 4 ? std::stoi(substrings[4]) : 0;
 			hitObject.ObjectParams = std::monostate{};
 			if (hitObject.Type == HitObject::Slider) {
 				// Get all object params
@@ -169,6 +165,7 @@ class CBeatmapLoader : public Raven::IAssetLoader {
 			READ_GENERAL(AudioHash);
 			READ_GENERAL(PreviewTime);
 			READ_GENERAL(Countdown);
+			READ_GENERAL(SampleSet);
 		}
 		#undef READ_GENERAL
 	}
@@ -223,7 +220,8 @@ class CBeatmapLoader : public Raven::IAssetLoader {
 	Result Load(Raven::App& app, Context ctx) final {
 		CBeatmap map{};
 		std::filesystem::path path{ctx.absolutePath};
-		map.m_path = path.parent_path().string();
+		map.m_path     = path.parent_path().string();
+		map.m_filePath = path.string();
 		ParseFile(map, ctx);
 		return Result::Success(app.GetResource<Raven::Assets<CBeatmap>>()
 								   ->Create(std::move(map))
@@ -254,9 +252,111 @@ class CBeatmapLoader : public Raven::IAssetLoader {
 	}
 };
 
+TDifficultyProperties ComputeDifficultyProps(const CBeatmap&   beatmap,
+											 const Difficulty& difficulty) {
+	auto computeRadius = [](const float cs) {
+		constexpr float BaseRad      = 54.4f;
+		constexpr float ShrinkFactor = 4.48f;
+		return BaseRad - ShrinkFactor * cs;
+	};
+	auto computeFadeIn = [](const float ar) {
+		if (ar < 5) {
+			return 800.f + 400.f * (5.f - ar) / 5.f;
+		} else if (ar == 5) {
+			return 800.f;
+		} else {
+			return 800.f - 500.f * (ar - 5.f) / 5.f;
+		}
+	};
+
+	auto computePreempt = [](const float ar) {
+		if (ar < 5) {
+			return 1200.f + 600.f * (5.f - ar) / 5.f;
+		} else if (ar == 5) {
+			return 1200.f;
+		} else {
+			return 1200.f - 750.f * (ar - 5.f) / 5.f;
+		}
+	};
+
+	auto computeSliderLength = [](const int   sliderRepeat,
+								  const float sliderPixelLength,
+								  float sliderMul, float velocity,
+								  float beatLen = 300) {
+		return (sliderPixelLength /
+				(std::max(sliderMul, 0.01f) * 100.f * velocity) * beatLen) *
+			   (std::max(sliderRepeat, 1));
+	};
+
+	const auto fadein  = computeFadeIn(difficulty.ApproachRate);
+	const auto preempt = computePreempt(difficulty.ApproachRate);
+	const auto radius  = computeRadius(difficulty.CircleSize);
+
+	TDifficultyProperties props;
+	props.reserve(beatmap.GetHitObjects().size());
+	for (const auto& hitObj : beatmap.GetHitObjects()) {
+		const std::pair<float, float> duration = [&] {
+			if(hitObj.Type == HitObject::Slider) {
+				const auto& slider = std::get<HitCurve>(hitObj.ObjectParams);
+				const float len = computeSliderLength(slider.Slides, slider.Length,
+										  difficulty.SliderMultiplier,
+										  1.f/* TODO: Slider velocity multiplier comes from timing points*/);
+				return std::pair<float, float>{len, len * slider.Slides};
+			} else {
+				return std::pair{0.f, 0.f};
+			}
+		}();
+		props.emplace_back(DifficultyProperties{
+			.Radius         = radius,
+			.Preempt        = preempt,
+			.FadeIn         = fadein,
+			.DurationSingle = duration.first,
+			.DurationTotal  = duration.second,
+		});
+	}
+	return props;
+}
+
+//! Derived per object properties, kept around so retrying a map reuses them.
+//! Keyed by the .osu file, asset indices are reused once a beatmap is released.
+class CDifficultyCache {
+  public:
+	static constexpr size_t Capacity = 16;
+
+	std::shared_ptr<const TDifficultyProperties>
+	GetOrCompute(const CBeatmap& beatmap, const Difficulty& difficulty) {
+		Key key{std::string{beatmap.GetFilePath()}, difficulty.CircleSize,
+				difficulty.ApproachRate, difficulty.SliderMultiplier};
+		const auto it = std::ranges::find(m_cache, key, &Entry::first);
+		// The file may have been edited since, its objects changed
+		if (it != std::end(m_cache) && it->second->size() == beatmap.GetHitObjects().size()) {
+			// Most recently used last
+			std::rotate(it, it + 1, std::end(m_cache));
+			return m_cache.back().second;
+		}
+		if (it != std::end(m_cache))
+			m_cache.erase(it);
+		if (m_cache.size() >= Capacity)
+			m_cache.erase(std::begin(m_cache));
+
+		auto props = std::make_shared<const TDifficultyProperties>(
+			ComputeDifficultyProps(beatmap, difficulty));
+		RavenAssert(props->size() == beatmap.GetHitObjects().size(),
+					"Difficulty properties do not match the hit objects!");
+		m_cache.emplace_back(std::move(key), props);
+		return props;
+	}
+
+  private:
+	using Key   = std::tuple<std::string, float, float, float>;
+	using Entry = std::pair<Key, std::shared_ptr<const TDifficultyProperties>>;
+	std::vector<Entry> m_cache;
+};
+
 void InitialiseHitObjects(
-	CWorld& world, App& app, SAssetManager& mgr,
-	const Raven::Assets<CBeatmap>& beatmaps,
+	CWorld& world, App& app,
+	const Raven::Assets<CBeatmap>& beatmaps, CDifficultyCache& difficultyCache,
+	CGameClock& clock, const GameMods& mods,
 	const Raven::Query<Raven::With<CBeatmapController,
 								   Raven::Initialised<CBeatmapController>>>&
 		components) {
@@ -267,39 +367,125 @@ void InitialiseHitObjects(
 		if (!pBeatmap)
 			continue;
 		comp.Difficulty = pBeatmap->GetDifficulty();
+		comp.Properties = difficultyCache.GetOrCompute(*pBeatmap, comp.Difficulty);
 
 		// Offset hit objects to not be clipped by screen
 		world.AddOrReplace<STransformComponent>(hBmap).m_translation.xy = float2{100, 100};
 		world.AddComponent<GameScores>(hBmap);
-		auto hSong      = mgr.Load(app, pBeatmap->GetSongPath())
-						 .OnSuccess()
-						 .Typed<Audio::Sound>();
-		world.AddOrReplace<Audio::Player>(hBmap,
-										  Audio::Player{.Sound         = hSong,
-														.PlaybackSpeed = 1.f,
-														.Volume        = 1.f,
-														.IsLooping     = false,
-														.IsPlaying     = true});
-
-		comp.CurrentTime = 0;
+		world.AddComponent<ScoresChanged>(hBmap);
+		// TODO: RavenAudio decodes the song in full, resident memory grows with
+		// its length. Streaming needs a decode-ahead mode with a bounded buffer,
+		// PlayingTime and seeking in Audio::Sound itself.
+		// The song stays resident only while the controller entity holds the
+		// player. The menu hands it over already loaded, only other callers
+		// load it here.
+		if (!world.Has<Audio::Player>(hBmap)) {
+			auto songRes = LoadAsset(app, pBeatmap->GetSongPath());
+			Handle<Audio::Sound> hSong{};
+			if (songRes.IsSuccess()) {
+				hSong = songRes.OnSuccess().Typed<Audio::Sound>();
+			} else {
+				RavenLogWarning("Failed to load song {}: {}", pBeatmap->GetSongPath(),
+								songRes.OnFailed());
+			}
+			world.AddComponent<Audio::Player>(hBmap, Audio::Player{.Sound = hSong});
+		}
+		auto& player         = world.GetComponent<Audio::Player>(hBmap);
+		player.PlaybackSpeed = mods.Rate;
+		player.Volume        = 1.f;
+		player.IsLooping     = false;
+		player.IsPlaying     = true;
+
+		comp.CurrentTime = 0.0;
 		comp.MaxTime     = pBeatmap->GetHitObjects().back().Time;
-		for (const auto& hit : pBeatmap->GetHitObjects()) {
+		comp.NextObject  = 0;
+		clock.Reset(0.0, GetMonotonicTimeMs(), mods.Rate);
+		world.AddOrReplace<StaticTransformRoot>(hBmap);
+	}
+}
+
+// Hit objects are only materialised shortly before they appear and are
+// despawned once judged, so the number of live entities follows the on-screen
+// density rather than the map length.
+void SpawnUpcomingObjects(
+	CWorld& world, const Raven::Assets<CBeatmap>& beatmaps,
+	const SimulationState&                                      sim,
+	const Query<With<CBeatmapController, STransformComponent>>& controllers) {
+	// The simulation thread works off the beatmap directly
+	if (sim.IsRunning())
+		return;
+
+	constexpr int64  SpawnLookahead    = 1000; // ms before an object appears
+	constexpr uint32 MaxSpawnsPerFrame = 32;
+
+	for (auto hBmap : controllers) {
+		auto&       comp     = controllers.get<CBeatmapController>(hBmap);
+		const auto* pBeatmap = beatmaps.Get(comp.Beatmap);
+		if (!pBeatmap || !comp.Properties)
+			continue;
+		const auto& rootTranslation =
+			controllers.get<STransformComponent>(hBmap).m_translation;
+		const auto hitObjects = pBeatmap->GetHitObjects();
+
+		for (uint32 spawned = 0; spawned < MaxSpawnsPerFrame &&
+								 comp.NextObject < hitObjects.size();
+			 ++spawned) {
+			const auto& hit = hitObjects[comp.NextObject];
+			if (hit.Time > comp.CurrentTime + SpawnLookahead)
+				break;
+
 			auto hHit = world.CreateChild(hBmap);
 			world.AddComponent<Tags::NoSerialise>(hHit);
 			world.AddComponent<Tags::NoCopy>(hHit);
-			world.AddComponent<S2DTransformTag>(hHit);
 			world.AddComponent<HitObject>(hHit, hit);
-			world.AddComponent<STransformComponent>(hHit).m_translation = {
-				hit.X, hit.Y, 0.f};
+			world.AddComponent<DifficultyProperties>(
+				hHit, (*comp.Properties)[comp.NextObject]);
+			const float3 local{hit.X, hit.Y, 0.f};
+			world.AddComponent<StaticTransform>(hHit).Local = local;
+			world.AddComponent<WorldSpaceTransform>(hHit).m_translation =
+				rootTranslation + local;
+			++comp.NextObject;
+		}
+	}
+}
+
+void DespawnJudgedObjects(
+	CWorld& world,
+	const Query<With<HitObject, Judged>, WithOut<VisibilityProperties>>& judged) {
+	for (auto hObj : judged) {
+		world.RemoveEntity(hObj);
+	}
+}
+
+// Only the translation of the root is taken into account, controllers are
+// never rotated or scaled.
+void ResolveStaticTransforms(
+	CWorld& world,
+	const Query<With<STransformComponent, StaticTransformRoot, SParentComponent>>& roots,
+	const Query<With<StaticTransform>>& statics) {
+	for (auto hRoot : roots) {
+		const auto& translation = roots.get<STransformComponent>(hRoot).m_translation;
+		auto&       root        = roots.get<StaticTransformRoot>(hRoot);
+		if (!root.IsDirty && root.Applied == translation)
+			continue;
+
+		auto next = roots.get<SParentComponent>(hRoot).first;
+		while (next) {
+			world.AddOrReplace<WorldSpaceTransform>(next).m_translation =
+				translation + statics.get<StaticTransform>(next).Local;
+			next = world.GetComponent<SHierarchyComponent>(next).next;
 		}
+		root.Applied = translation;
+		root.IsDirty = false;
 	}
 }
 
 void AdvanceSimulation(
 	const Query<With<CBeatmapController, SParentComponent, Audio::Player>>&
 					   controllers,
-	State<EGameState>& stateMachine) {
+	CGameClock& clock, State<EGameState>& stateMachine) {
 
+	const double now = GetMonotonicTimeMs();
 	for (const auto& hController : controllers) {
 		const auto& player = controllers.get<Audio::Player>(hController);
 		if (!player.IsPlaying) {
@@ -307,14 +493,24 @@ void AdvanceSimulation(
 			break;
 		}
 		controllers.get<CBeatmapController>(hController).CurrentTime =
-			player.PlayingTime;
+			clock.Update(static_cast<double>(player.PlayingTime), now,
+						 player.PlaybackSpeed);
 	}
 }
 
-void RemoveAllMaps(CWorld& world, const Query<With<CBeatmapController>>& beatmaps) {
+void RemoveAllMaps(CWorld& world, JudgementEffects& effects,
+				   const CGameClock&                      clock,
+				   const Query<With<CBeatmapController>>& beatmaps) {
 	for (const auto& hController : beatmaps) {
 		world.RemoveEntity(hController);
 	}
+	effects.Clear();
+
+	const auto& stats = clock.GetStats();
+	RavenLogInfo("Clock drift over {} audio updates: mean {:.3f}ms, stddev "
+				 "{:.3f}ms, max {:.3f}ms, max step {:.3f}ms",
+				 stats.Samples, stats.MeanDrift, stats.GetDriftStdDev(),
+				 stats.MaxAbsDrift, stats.MaxFrameStep);
 }
 
 void EndSimulation(
@@ -332,23 +528,78 @@ void EndSimulation(
 
 }
 
-Skin LoadSkin(App& app, std::string_view skinDir) {
-	auto&                mgr = *app.GetResource<SAssetManager>();
-	Skin                 skin{};
-	constexpr std::array ImagesToLoad = {
-		"approachcircle",
-		"hitcircle",
-		"hitcircleoverlay",
-		"sliderb0",
-		"hit0",
-		"hit50",
-		"hit100",
-		"hit300",
-		"cursor",
-	};
-	for (const auto* pImg : ImagesToLoad) {
-		std::string path = std::string{skinDir} + pImg + ".png";
-		auto        hRes = mgr.Load(app, path);
+constexpr std::array SkinImageNames = {
+	"approachcircle",
+	"hitcircle",
+	"hitcircleoverlay",
+	"sliderb0",
+	"hit0",
+	"hit50",
+	"hit100",
+	"hit300",
+	"cursor",
+	"cursortrail",
+};
+
+// Optional, the HUD falls back to text without the full set
+constexpr std::array<std::string_view, ScoreGlyphCount> ScoreGlyphNames = {
+	"score-0", "score-1", "score-2", "score-3",       "score-4",  "score-5", "score-6",
+	"score-7", "score-8", "score-9", "score-dot", "score-percent", "score-x",
+};
+
+// Source of the image for `level`, skins without an @2x image use the base one
+std::filesystem::path GetSkinImageSource(const std::filesystem::path& skinDir,
+										 const std::string_view name, const int32 level) {
+	std::error_code err;
+	if (level < 0) {
+		auto source = skinDir / fmt::format("{}@2x.png", name);
+		if (std::filesystem::exists(source, err))
+			return source;
+	}
+	return skinDir / fmt::format("{}.png", name);
+}
+
+// Decoded copy of `source` from the skin cache, the source if it cannot be cached
+std::string GetSkinImagePath(CSkinCache& cache, const std::filesystem::path& source,
+							 const int32 level) {
+	return cache.GetOrCreate(source, static_cast<uint32>(std::max(level, 0)))
+		.value_or(source.string());
+}
+
+// Source to load instead of `failedPath`, which is dropped from the skin cache
+std::optional<std::string> GetSkinImageFallback(CSkinCache&                  cache,
+												const std::filesystem::path& source,
+												const std::string&           failedPath) {
+	if (failedPath == source.string())
+		return std::nullopt;
+	cache.Remove(failedPath);
+	return source.string();
+}
+
+auto LoadSkinImage(App& app, CSkinCache& cache, const std::filesystem::path& skinDir,
+				   const std::string_view name, const int32 level) {
+	const auto source = GetSkinImageSource(skinDir, name, level);
+	const auto path   = GetSkinImagePath(cache, source, level);
+	auto       hRes   = LoadAsset(app, path);
+	if (hRes.IsSuccess())
+		return hRes;
+	const auto fallback = GetSkinImageFallback(cache, source, path);
+	if (!fallback)
+		return hRes;
+	RavenLogWarning("Cached {} failed to load, using {}", path, *fallback);
+	return LoadAsset(app, *fallback);
+}
+
+std::filesystem::path GetSkinDir(App& app, const std::string_view skinDir) {
+	return SAssetManager::ResolvePath(app, std::string{skinDir}).m_absolutePath;
+}
+
+Skin LoadSkin(App& app, CSkinCache& cache, std::string_view skinDir, const int32 level) {
+	const auto dir = GetSkinDir(app, skinDir);
+	Skin       skin{};
+	skin.Level = level;
+	for (const auto* pImg : SkinImageNames) {
+		auto hRes = LoadSkinImage(app, cache, dir, pImg, level);
 		if (hRes.IsSuccess()) {
 			skin.Images[pImg] = hRes.OnSuccess().Typed<CImage>();
 		} else {
@@ -357,80 +608,119 @@ Skin LoadSkin(App& app, std::string_view skinDir) {
 		}
 	}
 
-	app.GetResource<Window::Cursors>()->Set(Window::ECursorType::Arrow, skin.Images["cursor"]);
+	for (uint32 i = 0; i < ScoreGlyphCount; ++i) {
+		auto hRes = LoadSkinImage(app, cache, dir, ScoreGlyphNames[i], level);
+		if (hRes.IsSuccess())
+			skin.ScoreGlyphs[i] = hRes.OnSuccess().Typed<CImage>();
+	}
+	if (!skin.HasScoreGlyphs()) {
+		RavenLogWarning("Skin {} has no complete score font, using text", skinDir);
+	}
+	cache.Save();
 	return skin;
 }
 
-void ComputeDifficultyProps(
-	CWorld& world,
-	const Query<With<CBeatmapController, SParentComponent>>& controllers,
-	const Query<With<HitObject>, WithOut<DifficultyProperties>>& toExtract) {
-	auto computeRadius = [](const float cs) {
-		constexpr float BaseRad      = 54.4f;
-		constexpr float ShrinkFactor = 4.48f;
-		return BaseRad - ShrinkFactor * cs;
-	};
-	auto computeFadeIn = [](const float ar) {
-		if (ar < 5) {
-			return 800.f + 400.f * (5.f - ar) / 5.f;
-		} else if (ar == 5) {
-			return 800.f;
-		} else {
-			return 800.f - 500.f * (ar - 5.f) / 5.f;
-		}
-	};
+//! Skin images loading for another resolution, swapped in together once all
+//! finished so a frame never mixes levels
+struct SkinReload {
+	int32 Level     = 0;
+	bool  IsPlaying = false; // Neither started nor swapped in during a map
+	std::vector<std::pair<const char*, TAssetFuture<CImage>>> Images;
+	std::array<TAssetFuture<CImage>, ScoreGlyphCount>        ScoreGlyphs{};
+
+	bool IsPending() const { return !Images.empty(); }
+	bool IsReady() const {
+		return std::ranges::all_of(Images, [](const auto& img) { return img.second.IsReady(); }) &&
+			   std::ranges::all_of(ScoreGlyphs, [](const auto& glyph) {
+				   return !glyph.IsValid() || glyph.IsReady();
+			   });
+	}
+	void Cancel() {
+		for (auto& [pImg, future] : Images)
+			future.Cancel();
+		for (auto& future : ScoreGlyphs)
+			future.Cancel();
+		Images.clear();
+	}
+};
 
-	auto computePreempt = [](const float ar) {
-		if (ar < 5) {
-			return 1200.f + 600.f * (5.f - ar) / 5.f;
-		} else if (ar == 5) {
-			return 1200.f;
-		} else {
-			return 1200.f - 750.f * (ar - 5.f) / 5.f;
-		}
-	};
+void SwapSkinMaterials(App& app, std::span<const Handle<CImage>> released, const Skin& skin);
 
-	auto computeSliderLength = [](const int   sliderRepeat,
-								  const float sliderPixelLength,
-								  float sliderMul, float velocity,
-								  float beatLen = 300) {
-		return (sliderPixelLength /
-				(std::max(sliderMul, 0.01f) * 100.f * velocity) * beatLen) *
-			   (std::max(sliderRepeat, 1));
-	};
+void DeferSkinReload(SkinReload& reload) {
+	reload.IsPlaying = true;
+}
 
-	for(const auto& hController: controllers) {
-		auto next = controllers.get<SParentComponent>(hController).first;
-		const auto& controller = controllers.get<CBeatmapController>(hController);
-		const auto fadein  = computeFadeIn(controller.Difficulty.ApproachRate);
-		const auto preempt = computePreempt(controller.Difficulty.ApproachRate);
+void ResumeSkinReload(SkinReload& reload) {
+	reload.IsPlaying = false;
+}
 
-		while(next) {
-			const auto& hitObj = toExtract.get<HitObject>(next);
-			const std::pair<float, float> duration = [&] {
-				if(hitObj.Type == HitObject::Slider) {
-					const auto& slider = std::get<HitCurve>(hitObj.ObjectParams);
-					const float len = computeSliderLength(slider.Slides, slider.Length,
-											  controller.Difficulty.SliderMultiplier,
-											  1.f/* TODO: Slider velocity multiplier comes from timing points*/);
-					return std::pair<float, float>{len, len * slider.Slides};
-				} else {
-					return std::pair{0.f, 0.f};
-				}
-			}();
-			world.AddOrReplace<DifficultyProperties>(
-				next,
-				DifficultyProperties{
-					.Radius  = computeRadius(controller.Difficulty.CircleSize),
-					.Preempt = preempt,
-					.FadeIn  = fadein,
-					.DurationSingle = duration.first,
-					.DurationTotal  = duration.second,
+void ReloadSkinForResolution(Skin& skin, SkinReload& reload, const SkinCache& cache,
+							 const AsyncAssets& assets, const StartupTasks& startup,
+							 Window::Cursors&                 cursors,
+							 const Query<With<SRenderInfo>>& renderInfos) {
+	// The startup task owns the skin until it is loaded
+	if (startup.Tasks->GetLoadedTime() <= 0.0 || renderInfos.begin() == renderInfos.end())
+		return;
+	// Textures change size, sprites of a running map would jump
+	if (reload.IsPlaying)
+		return;
+	const auto& RI = renderInfos.get<SRenderInfo>(renderInfos.front());
+	if (RI.m_resolution.y <= 0)
+		return; // Minimised
+	// Same playfield size as GetMousePos
+	const int32 level = Skin::GetLevel(static_cast<float>(RI.m_resolution.y) * 0.9f);
+
+	if (reload.IsPending() && reload.Level != level) {
+		reload.Cancel(); // Resized again before the previous reload finished
+	}
+	if (!reload.IsPending()) {
+		if (level == skin.Level)
+			return;
+		const auto dir = GetSkinDir(App::Get(), DefaultSkinDir);
+		auto       load = [&](const std::string_view name) {
+			// Resolved on the worker, it stats and may write the cache
+			return assets.Loader->LoadWithFallback<CImage>(
+				[pCache = cache.Cache, dir, name, level]() -> std::optional<std::string> {
+					return GetSkinImagePath(*pCache, GetSkinImageSource(dir, name, level),
+											level);
+				},
+				[pCache = cache.Cache, dir, name, level](const std::string& failedPath) {
+					return GetSkinImageFallback(
+						*pCache, GetSkinImageSource(dir, name, level), failedPath);
 				});
-
-			next = world.GetComponent<SHierarchyComponent>(next).next;
+		};
+		reload.Level = level;
+		// Only what the skin has, missing images would fail again
+		for (const auto* pImg : SkinImageNames) {
+			if (skin.Images.contains(pImg))
+				reload.Images.emplace_back(pImg, load(pImg));
+		}
+		for (uint32 i = 0; i < ScoreGlyphCount; ++i) {
+			if (skin.ScoreGlyphs[i])
+				reload.ScoreGlyphs[i] = load(ScoreGlyphNames[i]);
 		}
+		return;
 	}
+	if (!reload.IsReady())
+		return;
+
+	// A failed image keeps the one of the previous level
+	std::vector<Handle<CImage>> released;
+	for (auto& [pImg, future] : reload.Images) {
+		if (auto hImage = future.Get())
+			released.push_back(std::exchange(skin.Images[pImg], std::move(hImage)));
+	}
+	for (uint32 i = 0; i < ScoreGlyphCount; ++i) {
+		if (auto hImage = reload.ScoreGlyphs[i].Get())
+			released.push_back(std::exchange(skin.ScoreGlyphs[i], std::move(hImage)));
+	}
+	SwapSkinMaterials(App::Get(), released, skin);
+	reload.Images.clear();
+	reload.ScoreGlyphs = {};
+	skin.Level         = level;
+	cursors.Set(Window::ECursorType::Arrow, skin.Images["cursor"]);
+	cache.Cache->Save();
+	RavenLogInfo("Reloaded skin for level {}", level);
 }
 
 void ComputeVisibleProps(
@@ -446,33 +736,10 @@ void ComputeVisibleProps(
 		while (next) {
 			const auto& hitObj = toExtract.get<HitObject>(next);
 			const auto& props  = toExtract.get<DifficultyProperties>(next);
-			const float dt     = static_cast<float>(currentTime - hitObj.Time);
-			const bool  isVisible =
-				dt > 0 && dt < props.Preempt + props.DurationTotal;
-
-			if (isVisible) {
-				const auto durationFac = dt - props.Preempt;
-				const auto iteration   = static_cast<int>(
-                    std::floor(durationFac / props.DurationSingle));
-				const auto slideTime =
-					durationFac - iteration * props.DurationSingle;
-				const auto t = iteration % 2 == 0
-								 ? slideTime / props.DurationSingle
-								 : 1.f - (slideTime / props.DurationSingle);
-
-				world.AddOrReplace<VisibilityProperties>(
-					next,
-					VisibilityProperties{
-						.TimeSinceSpawn = dt,
-						.ApproachAmount = glm::lerp(
-							1.f, 0.5f,
-							std::clamp(dt, 0.f, props.Preempt) / props.Preempt),
-						.SliderT = t * static_cast<float>(dt >= props.Preempt),
-					});
-			} else {
-				if (world.Has<VisibilityProperties>(next)) {
-					world.RemoveComponent<VisibilityProperties>(next);
-				}
+			if (const auto vis = ComputeVisibility(hitObj, props, currentTime)) {
+				world.AddOrReplace<VisibilityProperties>(next, *vis);
+			} else if (world.Has<VisibilityProperties>(next)) {
+				world.RemoveComponent<VisibilityProperties>(next);
 			}
 
 			next = world.GetComponent<SHierarchyComponent>(next).next;
@@ -481,10 +748,16 @@ void ComputeVisibleProps(
 }
 
 void GetMousePos(CWorld&                                  world,
+				 CursorTrail&                             trail,
+				 CursorPath&                              path,
 				 const Events<Event::System::SMouseMove>& mouseMove,
 				 const Query<With<SRenderInfo>>&          renderInfos) {
 	const auto hInfo = renderInfos.front();
 	const auto& RI = renderInfos.get<SRenderInfo>(hInfo);
+
+	// Events carry no timestamp, every sample of the frame shares its time
+	const double now       = GetMonotonicTimeMs();
+	path.PreviousFrameTime = std::exchange(path.LastFrameTime, now);
 	for (const auto& e : mouseMove) {
 		const uint2 cursorPos = uint2{static_cast<uint32>(e.newPosX),
 									  static_cast<uint32>(e.newPosY)} -
@@ -498,21 +771,10 @@ void GetMousePos(CWorld&                                  world,
 		const float2     texScale          = renderRes / TextureResolution;
 
 		if(!world.Has<ActiveMousePos>(hInfo)) {
-			auto hCursor = world.CreateEntity("CursorParticles");
-			world.AddComponent<Tags::NoCopy>(hCursor);
-			world.AddComponent<Tags::NoSerialise>(hCursor);
-			world.AddComponent<STransformComponent>(hCursor);
-			world.AddOrReplace<Particles::Emitter>(
-				hCursor,
-				Particles::Emitter{
-					.ToSpawn = 100,
-				});
-
 			world.AddComponent<ResolutionConversion>(hInfo);
 			world.AddOrReplace<ActiveMousePos>(hInfo,
 											   ActiveMousePos{
-												   .Pos          = cursorPos,
-												   .CursorEntity = hCursor,
+												   .Pos = cursorPos,
 											   });
 		}
 
@@ -525,133 +787,128 @@ void GetMousePos(CWorld&                                  world,
 		conv.ToOsuScale       = 1.f / resScale;
 		conv.FromTextureScale = texScale;
 		conv.ToTextureScale   = 1.f / texScale;
+
+		trail.Push(float2{cursorPos} * conv.ToOsuScale, now);
+		path.Push(float2{cursorPos} * conv.ToOsuScale, now);
 	}
 }
 
-bool AreKeysDown() {
-	return CInput::IsKeyDown(EKey::D) || CInput::IsKeyDown(EKey::F);
-}
-
-void UpdateHovered(CWorld& world, const Skin& skin,
-				   const Query<With<VisibilityProperties, WorldSpaceTransform,
-									DifficultyProperties, HitObject>>& objs,
-				   const Query<With<ActiveMousePos, ResolutionConversion>>& activeMouse) {
-	const auto& [mouse, conv] = activeMouse.GetSingle();
-	for(auto hObj: objs) {
-		const auto& pos = objs.get<WorldSpaceTransform>(hObj).m_translation.xy();
-		const auto& dif = objs.get<DifficultyProperties>(hObj);
-		const auto& vis = objs.get<VisibilityProperties>(hObj);
-
-		const bool  isHovered = glm::distance(pos, float2{float2{mouse.Pos} * conv.ToOsuScale}) < dif.Radius;
-		if(isHovered) {
-			world.AddOrReplace<Hovered>(hObj);
-			if(AreKeysDown() && !world.Has<ScoreDriver>(hObj)) {
-				int score = 0;
-				if(vis.ApproachAmount >= 0.8) {
-					score = 300;
-				} else if(vis.ApproachAmount >= 0.5) {
-					score = 100;
-				} else {
-					score = 50;
-				}
-				CreateScoreDriver(world, skin, hObj, score, pos * conv.FromOSUScale, dif.DurationTotal);
-			}
-		} else if (world.Has<Hovered>(hObj)) {
-			world.RemoveComponent<Hovered>(hObj);
+// Stamped with the frame times of the cursor path, the events have no time of
+// their own (see KeyPress). Runs after GetMousePos and FeedSimulation so the
+// samples a press is judged against were recorded and forwarded first.
+void CollectKeyPresses(const Events<Event::System::SKeyPress>& events,
+					   const KeyPressQueue& presses, const CursorPath& path) {
+	for (const auto& e : events) {
+		if (e.eKeyAction != EKeyAction::Press ||
+			std::ranges::find(GameplayKeys, e.ePressedKey) ==
+				std::end(GameplayKeys))
+			continue;
+		const KeyPress press{
+			.Key = e.ePressedKey, .Time = path.LastFrameTime, .Since = path.PreviousFrameTime};
+		if (!presses.Queue->TryPush(press)) {
+			RavenLogWarning("Key press queue is full, dropping input!");
 		}
 	}
 }
 
-void CleanUpInteractions(CWorld& world,
-				   const Query<With<Hovered, WithOut<VisibilityProperties>>>& objs,
-				   const Query<With<ActiveMousePos>>& activeMouse) {
-	world.GetRegistry().remove<Hovered>(objs.begin(), objs.end());
-}
+// Each press judges at most one object, the earliest unjudged one the cursor
+// passed over during the press' frame whose hit window contains the press
+// time. Timing accuracy is still bounded by the frame time.
+void JudgeKeyPresses(
+	CWorld& world, JudgementEffects& effects, const KeyPressQueue& presses,
+	const CGameClock& clock, const CursorPath& path, const SimulationState& sim,
+	const HitsoundQueue& hitsounds, const HitsoundBank& bank,
+	const Query<With<CBeatmapController, SParentComponent>>& controllers,
+	const Query<With<HitObject, DifficultyProperties, WorldSpaceTransform>>& objs) {
+	// The simulation thread is the consumer of the queue when running
+	if (sim.IsRunning())
+		return;
+	while (const auto press = presses.Queue->TryPop()) {
+		if (path.Count == 0)
+			continue;
+		const float pressTime = static_cast<float>(clock.GetTimeAt(press->Time));
+
+		for (const auto& hController : controllers) {
+			const auto& controller = controllers.get<CBeatmapController>(hController);
+			const auto  windows =
+				HitWindows::FromOD(controller.Difficulty.OverallDifficulty);
+
+			TEntity hBest{};
+			float   bestHitTime = std::numeric_limits<float>::max();
+			auto    next = controllers.get<SParentComponent>(hController).first;
+			while (next) {
+				const auto hObj = next;
+				next = world.GetComponent<SHierarchyComponent>(next).next;
+				if (world.Has<Judged>(hObj))
+					continue;
+
+				const auto& props   = objs.get<DifficultyProperties>(hObj);
+				const float hitTime = GetHitTime(objs.get<HitObject>(hObj), props);
+				const auto  pos =
+					objs.get<WorldSpaceTransform>(hObj).m_translation.xy();
+				if (std::abs(pressTime - hitTime) > windows.Meh ||
+					hitTime >= bestHitTime ||
+					!path.Intersects(pos, props.Radius, press->Since, press->Time))
+					continue;
+				hBest       = hObj;
+				bestHitTime = hitTime;
+			}
 
-void MarkMissedNotes(CWorld& world, const Skin& skin,
-					 const Query<With<Removed<VisibilityProperties>, HitObject,
-									  WorldSpaceTransform>,
-								 WithOut<ScoreDriver>>& missed,
-					 const Query<With<ResolutionConversion>>& activeMouse) {
-	const ResolutionConversion& res = activeMouse.GetSingle();
-	for(const auto hMissed: missed) {
-		const auto pos = missed.get<WorldSpaceTransform>(hMissed).m_translation.xy();
-		CreateScoreDriver(world, skin, hMissed, 0, pos * res.FromOSUScale, 0);
+			if (hBest) {
+				const int score = windows.Score(pressTime - bestHitTime);
+				hitsounds.Trigger(bank.DefaultSet, objs.get<HitObject>(hBest).HitSound,
+								  press->Time);
+				Judge(world, effects, hBest, score,
+					  objs.get<WorldSpaceTransform>(hBest).m_translation.xy(),
+					  objs.get<DifficultyProperties>(hBest).DurationTotal);
+				break;
+			}
+		}
 	}
 }
 
-void UpdateScore(CWorld& world, const Query<With<ScoreDriver>>& scores,
-				 const Query<With<STransformComponent, Sprite::SSprite>>& effects,
-				 const CTimestep&                        ts) {
-	for(auto& hScore: scores) {
-		auto& score = scores.get<ScoreDriver>(hScore);
-		score.TimeSinceSpawn += ts.GetMilliseconds();
-		const float scoreAlpha = 1.f / score.TotalTime;
-		auto& effectXForm  = effects.get<STransformComponent>(score.EffectEntity);
-		auto& effectSprite = effects.get<Sprite::SSprite>(score.EffectEntity);
-		effectXForm.m_translation.y -= scoreAlpha * 100.f;
-		effectSprite.customSize += scoreAlpha * 100.f;
+// Objects that were not hit until their last hit window closed are missed
+void MarkMissedNotes(
+	CWorld& world, JudgementEffects& effects,
+	const Query<With<CBeatmapController, SParentComponent>>& controllers,
+	const Query<With<HitObject, DifficultyProperties, WorldSpaceTransform>>& objs) {
+	for (const auto& hController : controllers) {
+		const auto& controller = controllers.get<CBeatmapController>(hController);
+		const auto  windows =
+			HitWindows::FromOD(controller.Difficulty.OverallDifficulty);
 
-		if(score.TimeSinceSpawn >= score.TotalTime) {
-			world.RemoveEntity(score.EffectEntity);
-			world.RemoveComponent<ScoreDriver>(hScore);
-			if(world.Has<Sprite::SSprite>(hScore))
-				world.RemoveComponent<Sprite::SSprite>(hScore);
+		auto next = controllers.get<SParentComponent>(hController).first;
+		while (next) {
+			const auto hObj = next;
+			next = world.GetComponent<SHierarchyComponent>(next).next;
+			if (world.Has<Judged>(hObj))
+				continue;
+
+			const float hitTime = GetHitTime(objs.get<HitObject>(hObj),
+											 objs.get<DifficultyProperties>(hObj));
+			if (controller.CurrentTime > hitTime + windows.Meh) {
+				Judge(world, effects, hObj, 0,
+					  objs.get<WorldSpaceTransform>(hObj).m_translation.xy(), 0);
+			}
 		}
 	}
 }
 
+void UpdateScore(JudgementEffects& effects, const CTimestep& ts) {
+	effects.Advance(ts.GetMilliseconds());
+}
+
 void CollectScores(
-	const Query<With<GameScores>>&                            scores,
-	const Query<With<Initialised<ScoreDriver>, ScoreDriver>>& newScores) {
+	CWorld&                                         world,
+	const Query<With<GameScores>>&                  scores,
+	const Query<With<Initialised<Judged>, Judged>>& newScores) {
+	if (newScores.begin() == newScores.end())
+		return;
 	GameScores& collector = scores.GetSingle();
 	for (auto hScore : newScores) {
-		auto& score = newScores.get<ScoreDriver>(hScore);
-		switch (score.Score) {
-		case 0: {
-			collector.Combo = 0;
-			collector.HitMiss++;
-			break;
-		}
-		case 50: {
-			collector.Combo++;
-			collector.Hit50++;
-			break;
-		}
-		case 100: {
-			collector.Combo++;
-			collector.Hit100++;
-			break;
-		}
-		case 300: {
-			collector.Combo++;
-			collector.Hit300++;
-			break;
-		}
-		default:
-			RavenLogWarning("Undefined score value: {}!", score.Score);
-			break;
-		}
-		collector.ScoreRaw += score.Score;
-		collector.Score += score.Score * std::max(1, collector.Combo);
-		collector.MaxCombo = std::max(collector.Combo, collector.MaxCombo);
-	}
-}
-
-void UpdateCursorParcile(
-	CWorld& world, const Query<With<SRenderInfo, ActiveMousePos>>& cursor,
-	const Query<With<Particles::Emitter, STransformComponent>>& particles) {
-
-	for (const auto& hCursor : cursor) {
-		const auto& RI = cursor.get<SRenderInfo>(hCursor);
-		const auto& pos = cursor.get<ActiveMousePos>(hCursor);
-		auto& emitter = particles.get<Particles::Emitter>(pos.CursorEntity);
-		float2 particlePos = pos.Pos;
-		particles.get<STransformComponent>(pos.CursorEntity).m_translation =
-			RI.m_mainCamera.ScreenToWorld(
-				float2{particlePos} / float2{RI.m_resolution}, 0.1f);
-		emitter.Burst(100);
+		collector.Add(newScores.get<Judged>(hScore).Score);
 	}
+	world.AddOrReplace<ScoresChanged>(scores.front());
 }
 
 struct GameState {
@@ -694,17 +951,14 @@ void CreateGameWorld(Raven::App& app, Assets<CWorld>& worlds) {
 }
 
 void BuildRenderingPlugin(Raven::App& app);
+void BuildSimulationPlugin(Raven::App& app);
+void BuildHitsoundPlugin(Raven::App& app);
 namespace UI {
 	void BuildUIPlugin(Raven::App& app);
 	void BuildPlayerHUD(Raven::App& app);
 	void BuildSplashScreen(Raven::App& app);
 }
 
-template <typename T> SystemDesc GameSystem(T&& sys) {
-	return SystemDesc{std::forward<T>(sys)}.WithCondition(
-		State<EGameState>::OnUpdate(EGameState::Playing));
-}
-
 template <typename T> SystemDesc PauseSystem(T&& sys) {
 	return SystemDesc{std::forward<T>(sys)}.WithCondition(
 		State<EGameState>::OnUpdate(EGameState::Paused));
@@ -728,26 +982,60 @@ struct Plugin {
 			.AddLoader<CBeatmapLoader>()
 			.AddComponent<CBeatmapController>()
 			.AddComponent<HitObject>()
+			.AddComponent<StaticTransform>()
 			.AddComponent<VisibilityProperties>() // To dispatch signals
-			.AddComponent<ScoreDriver>() // To dispatch signals
+			.AddComponent<Judged>() // To dispatch signals
+			.CreateResource<JudgementEffects>()
+			.CreateResource<CursorTrail>()
+			.CreateResource<CursorPath>()
+			.CreateResource<CDifficultyCache>()
+			.CreateResource<CGameClock>()
+			.CreateResource<GameMods>()
+			.CreateResource<AsyncAssets>()
+			.CreateResource<StartupTasks>()
+			.CreateResource<KeyPressQueue>()
 			.AddSystem(OSU::StateStage, MenuEnterSystem(&OSU::CreateGameWorld))
 			.AddSystem(DefaultStages::FIRST, &ToggleSimulation)
 			.AddSystem(OSU::StateStage, GameStartSystem(&OSU::InitialiseHitObjects))
-			.AddSystem(DefaultStages::PRE_UPDATE, &OSU::ComputeDifficultyProps)
+			.AddSystem(DefaultStages::PRE_UPDATE, GameSystem(&OSU::SpawnUpcomingObjects))
+			.AddSystem(DefaultStages::PRE_UPDATE, &OSU::ResolveStaticTransforms)
 			.AddSystem(DefaultStages::PRE_UPDATE, &OSU::GetMousePos)
 			.AddSystem(DefaultStages::UPDATE, &OSU::ComputeVisibleProps)
-			.AddSystem(DefaultStages::UPDATE, &OSU::MarkMissedNotes)
-			.AddSystem(DefaultStages::UPDATE, &OSU::UpdateHovered)
+			.AddSystem(DefaultStages::UPDATE, GameSystem(&OSU::MarkMissedNotes))
+			.AddSystem(DefaultStages::POST_UPDATE, GameSystem(&OSU::CollectKeyPresses))
+			.AddSystem(DefaultStages::UPDATE, GameSystem(&OSU::JudgeKeyPresses))
 			.AddSystem(DefaultStages::UPDATE, &OSU::UpdateScore)
 			.AddSystem(DefaultStages::POST_UPDATE, &OSU::CollectScores)
-			//.AddSystem(Raven::DefaultStages::UPDATE, &OSU::UpdateCursorParcile)
 			.AddSystem(OSU::StateStage, GameSystem(&AdvanceSimulation))
 			//.AddSystem(OSU::StateStage, GameSystem(&EndSimulation))
 			.AddSystem(OSU::StateStage, GameExitSystem(&RemoveAllMaps))
-			.AddSystem(DefaultStages::LAST, &CleanUpInteractions)
-			.CreateResource<OSU::Skin>(
-				LoadSkin(app, "project://Assets/Skins/- YUGEN -/"));
+			.AddSystem(DefaultStages::LAST, &OSU::DespawnJudgedObjects)
+			.CreateResource<OSU::Skin>()
+			.CreateResource<SkinReload>()
+			.AddSystem(DefaultStages::PRE_UPDATE, &OSU::ReloadSkinForResolution)
+			.AddSystem(OSU::StateStage, GameStartSystem(&OSU::DeferSkinReload))
+			.AddSystem(OSU::StateStage, GameExitSystem(&OSU::ResumeSkinReload))
+			.CreateResource<SkinCache>(SkinCache{
+				.Cache = std::make_shared<CSkinCache>(
+					SAssetManager::ResolvePath(app, "project://Cache/Skins").m_absolutePath),
+			});
+
+		// Loaded while the splash screen plays, see CStartupTasks
+		auto pSkin = std::make_shared<Skin>();
+		app.GetResource<StartupTasks>()->Tasks->Add(
+			"Skin",
+			[&app, pSkin] {
+				*pSkin = LoadSkin(app, *app.GetResource<SkinCache>()->Cache, DefaultSkinDir, 0);
+			},
+			[&app, pSkin] {
+				auto& skin = *app.GetResource<Skin>();
+				skin       = std::move(*pSkin);
+				app.GetResource<Window::Cursors>()->Set(Window::ECursorType::Arrow,
+														skin.Images["cursor"]);
+			});
 		BuildRenderingPlugin(app);
+		BuildSimulationPlugin(app);
+		BuildHitsoundPlugin(app);
 		OSU::UI::BuildUIPlugin(app);
 		OSU::UI::BuildPlayerHUD(app);
 	}
@@ -773,6 +1061,27 @@ int main(int argc, char* argv[]) {
 
 	OSU::UI::BuildSplashScreen(app);
 	app.AddPlugin<OSU::Plugin>();
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg{argv[i]};
+		auto&                  mods = *app.GetResource<OSU::GameMods>();
+		if (arg == "--sim-thread") {
+			app.GetResource<OSU::SimulationSettings>()->Threaded = true;
+		} else if (arg == "--dt") {
+			mods.Rate = OSU::GameMods::DoubleTime;
+		} else if (arg == "--ht") {
+			mods.Rate = OSU::GameMods::HalfTime;
+		} else if (arg.starts_with("--rate=")) {
+			const auto value = arg.substr(7);
+			float      rate  = 1.f;
+			const auto [pEnd, err] =
+				std::from_chars(value.data(), value.data() + value.size(), rate);
+			if (err != std::errc{} || pEnd != value.data() + value.size()) {
+				RavenLogWarning("Ignoring invalid {}", arg);
+				continue;
+			}
+			mods.Rate = std::clamp(rate, 0.5f, 2.f);
+		}
+	}
 
 	if(!params.m_bInitialiseEditor) {
 #if 0